@@ -30,7 +30,7 @@
 #ifndef CPP_TOOL_KIT_FACTORY_BUILDER_H_
 #define CPP_TOOL_KIT_FACTORY_BUILDER_H_
 
-#include <functional>
+#include <type_traits>
 #include <vector>
 
 #include "core_extension.h"
@@ -42,24 +42,35 @@ namespace factory {
 /// @brief Helper for registration objects
 class Builder {
  public:
-  Builder() noexcept = default;
+  /// @brief Create Builder
+  /// @param resource [in] source of memory for the Core and by default for
+  /// contexts of registered objects, must outlive the Core
+  explicit Builder(MemoryResource* resource = NewDeleteResource()) noexcept
+      : resource_(resource), is_no_memory_(false){};
   ~Builder() noexcept = default;
 
   /// Create fluent helper allows to set properties for the registered
   /// object
   /// @tparam T type of managed object
-  /// @param create [in] function for create instance of managed object
-  /// @return Reference to helper
-  template <typename T>
-  engine::BuildItem<T>& Register(
-      std::function<T*(Resolver&)>&& create) noexcept;
+  /// @tparam F type of creator (a lambda, a function), callable as
+  /// 'T*(Resolver&)', it is kept by the instance manager without type erasure
+  /// @param create [in] creator of instance of managed object
+  /// @return Reference to helper, its type depends on the type of creator,
+  /// keep it as 'auto&' ('BuildItem<T>&' is the helper of 'std::function')
+  template <typename T, typename F>
+  engine::BuildItem<T, typename std::decay<F>::type>& Register(
+      F&& create) noexcept;
 
   /// Create fluent helper allows to set properties for the registered
-  /// object without dependencies
+  /// object, the object is created from its constructor arguments
+  /// 'T(Deps*...)', the dependencies are got with the default key. To
+  /// register the object as its interface call 'As<Interface>()'
   /// @tparam T type of managed object
-  /// @return Reference to helper
-  template <typename T>
-  engine::BuildItem<T>& RegisterType() noexcept;
+  /// @tparam ...Deps types of constructor arguments
+  /// @return Reference to helper, keep it as 'auto&'
+  template <typename T, typename... Deps>
+  engine::BuildItem<T, engine::TypeCreator<T, Deps...>>&
+  RegisterType() noexcept;
 
   /// @brief Create Core, if the Core is nullptr check 'Error()'
   /// @return std::unique_ptr<Core> for produce objects
@@ -77,31 +88,42 @@ class Builder {
   bool Build(engine::CoreExtension* core) noexcept;
 
  private:
+  MemoryResource* resource_;
   std::vector<engine::PtrHolder<engine::ABuildItem>> items_;
+  bool is_no_memory_;  // a registration was lost, the build fails
   std::string error_;
 };
 
 // Implementation
 
-template <typename T>
-inline engine::BuildItem<T>& Builder::Register(
-    std::function<T*(Resolver&)>&& create) noexcept {
-  engine::PtrHolder<engine::BuildItem<T>> item =
-      engine::MakePtrHolder<engine::BuildItem<T>>(std::move(create));
-  engine::BuildItem<T>* ptr = item.Get();
+template <typename T, typename F>
+inline engine::BuildItem<T, typename std::decay<F>::type>& Builder::Register(
+    F&& create) noexcept {
+  typedef engine::BuildItem<T, typename std::decay<F>::type> Item;
+  engine::PtrHolder<Item> item =
+      engine::MakePtrHolder<Item>(std::forward<F>(create));
+  Item* ptr = item.Get();
+  if (ptr == nullptr) {
+    is_no_memory_ = true;
+    return engine::DetachedItem<Item>(std::forward<F>(create));
+  }
+
   items_.push_back(std::move(item));
   return *ptr;
 }
 
-template <typename T>
-inline engine::BuildItem<T>& Builder::RegisterType() noexcept {
-  std::function<T*(Resolver&)> create = [](Resolver& resolver) -> T* {
-    return Create<T>();
-  };
-  return Register(std::move(create));
+template <typename T, typename... Deps>
+inline engine::BuildItem<T, engine::TypeCreator<T, Deps...>>&
+Builder::RegisterType() noexcept {
+  return Register<T>(engine::TypeCreator<T, Deps...>());
 }
 
 inline bool Builder::Build(engine::CoreExtension* core) noexcept {
+  if (is_no_memory_) {
+    error_ = "There is no memory for registration of an object";
+    return false;
+  }
+
   if (items_.size() == 0) {
     error_ = "There are no object for registration, list is empty";
     return false;
@@ -115,13 +137,19 @@ inline bool Builder::Build(engine::CoreExtension* core) noexcept {
   }
 
   items_.clear();
+  core->Freeze();
+
+  if (!core->CheckCycles()) {
+    error_ = core->LastError();
+    return false;
+  }
 
   return true;
 }
 
 inline std::unique_ptr<Core> Builder::BuildUnique() noexcept {
-  std::unique_ptr<engine::CoreExtension> uptr_core(new (std::nothrow)
-                                                       engine::CoreExtension());
+  std::unique_ptr<engine::CoreExtension> uptr_core(
+      new (std::nothrow) engine::CoreExtension(resource_));
   if (Build(uptr_core.get())) {
     return uptr_core;
   }
@@ -131,8 +159,8 @@ inline std::unique_ptr<Core> Builder::BuildUnique() noexcept {
 }
 
 inline std::shared_ptr<Core> Builder::BuildShared() noexcept {
-  std::shared_ptr<engine::CoreExtension> sptr_core(new (std::nothrow)
-                                                       engine::CoreExtension());
+  std::shared_ptr<engine::CoreExtension> sptr_core(
+      new (std::nothrow) engine::CoreExtension(resource_));
   if (Build(sptr_core.get())) {
     return sptr_core;
   }
@@ -31,11 +31,21 @@
 #define CPP_TOOL_KIT_FACTORY_CORE_H_
 
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include "factory.h"
+#include "handle.h"
+#include "lazy.h"
 #include "manager/base_instance_manager.h"
+#include "manager/context/resource_context.h"
+#include "manager/context/shared_context.h"
 #include "tool/common.h"
+#include "tool/flat_index.h"
+#include "tool/memory_resource.h"
 #include "u_ptr.h"
 
 namespace cpptoolkit {
@@ -44,57 +54,317 @@ namespace factory {
 /// @brief Contains all data about registered classes
 class Core {
  public:
-  Core() = default;
+  /// @brief Create Core
+  /// @param resource [in] source of memory for internal structures
+  explicit Core(MemoryResource* resource = NewDeleteResource()) noexcept
+      : resource_(resource),
+        managers_(resource),
+        index_(resource),
+        keyed_index_(resource),
+        misses_(resource),
+        miss_contexts_(resource){};
   virtual ~Core() = default;
 
+  /// @brief Get source of memory for internal structures
+  /// @return Pointer to the resource
+  MemoryResource* Resource() const noexcept { return resource_; };
+
+  /// @brief Get context with managed object registered with the default key
+  /// @tparam T type of managed object
+  /// @return unique_ptr with BaseContext instance of managed object
+  template <typename T>
+  engine::PtrHolder<engine::BaseContext<T>> GetContext() noexcept;
+
   /// @brief Get context with managed object
   /// @tparam T type of managed object
   /// @param key [in] unique key for a given object type
   /// @return unique_ptr with BaseContext instance of managed object
   template <typename T>
   engine::PtrHolder<engine::BaseContext<T>> GetContext(
-      const std::string& key) noexcept;
+      const Key& key) noexcept;
+
+  /// @brief Get context with managed object over pre-resolved handle
+  /// @tparam T type of managed object
+  /// @param handle [in] handle of registered object
+  /// @return unique_ptr with BaseContext instance of managed object
+  template <typename T>
+  engine::PtrHolder<engine::BaseContext<T>> GetContext(
+      const Handle<T>& handle) noexcept;
+
+  /// @brief Get instance of BL object registered with the default key
+  /// @tparam T type of managed object
+  /// @return Instance of BL object in UPtr wrapper
+  template <typename T>
+  UPtr<T> Get() noexcept;
 
   /// @brief Get instance of BL object in RAII wrapper
   /// @tparam T type of managed object
   /// @param key [in] unique key for a given object type
   /// @return Instance of BL object in UPtr wrapper
   template <typename T>
-  UPtr<T> Get(const std::string& key = engine::DEFAULT_KEY) noexcept;
+  UPtr<T> Get(const Key& key) noexcept;
+
+  /// @brief Get instance of BL object over pre-resolved handle, skips lookup
+  /// of registered object
+  /// @tparam T type of managed object
+  /// @param handle [in] handle of registered object
+  /// @return Instance of BL object in UPtr wrapper
+  template <typename T>
+  UPtr<T> Get(const Handle<T>& handle) noexcept;
+
+  /// @brief Find registered object with the default key and save access to it
+  /// @tparam T type of managed object
+  /// @return Handle of registered object, check 'IsValid()'
+  template <typename T>
+  Handle<T> Resolve() const noexcept;
+
+  /// @brief Find registered object and save access to it
+  /// @tparam T type of managed object
+  /// @param key [in] unique key for a given object type
+  /// @return Handle of registered object, check 'IsValid()'
+  template <typename T>
+  Handle<T> Resolve(const Key& key) const noexcept;
+
+  /// @brief Check if object is registered
+  /// @tparam T type of managed object
+  /// @param key [in] unique key for a given object type
+  /// @return Check result
+  template <typename T>
+  bool Contains(const Key& key = engine::DEFAULT_KEY) const noexcept;
+
+  /// @brief Get instance of BL object if it is registered, does not allocate
+  /// memory for not registered object
+  /// @tparam T type of managed object
+  /// @param key [in] unique key for a given object type
+  /// @return Instance of BL object in UPtr wrapper, the wrapper is empty
+  /// (the code is 'kNotInitialized', there is no error context) if the
+  /// object is not registered
+  template <typename T>
+  UPtr<T> TryGet(const Key& key = engine::DEFAULT_KEY) noexcept;
+
+  /// @brief Delete cached memory of contexts of all registered objects
+  void TrimCache() noexcept;
 
  protected:
-  std::unordered_map<std::string, engine::PtrHolder<engine::AInstanceManager>>
-      index_;
+  /// @brief Get context from the manager
+  /// @tparam T type of managed object
+  /// @param manager [in] instance manager or nullptr if it is not registered
+  /// @param key [in] unique key for a given object type
+  /// @return unique_ptr with BaseContext instance of managed object
+  template <typename T>
+  engine::PtrHolder<engine::BaseContext<T>> GetContext(
+      engine::AInstanceManager* manager, const Key& key) noexcept;
+
+  /// @brief Get error context for not registered object, the context is
+  /// created once for (type, key) and shared by reference counting, so it
+  /// can outlive the Core
+  /// @tparam T type of managed object
+  /// @param key [in] unique key for a given object type
+  /// @return Error context
+  template <typename T>
+  engine::PtrHolder<engine::BaseContext<T>> NotRegistered(
+      const Key& key) noexcept;
+
+  /// @brief Find manager registered with the default key
+  /// @param type_id [in] number of the managed object type
+  /// @return Manager or nullptr if the type is not registered
+  engine::AInstanceManager* Find(uint32_t type_id) const noexcept;
+
+  /// @brief Find manager registered with the key
+  /// @param type_id [in] number of the managed object type
+  /// @param key [in] unique key for a given object type
+  /// @return Manager or nullptr if the type is not registered
+  engine::AInstanceManager* Find(uint32_t type_id,
+                                 const Key& key) const noexcept;
+
+ protected:
+  template <typename V>
+  using Vector = std::vector<V, engine::ResourceAllocator<V>>;
+
+  MemoryResource* resource_;
+
+  // all registered managers, owns them
+  Vector<engine::PtrHolder<engine::AInstanceManager>> managers_;
+
+  // managers registered with the default key by type number
+  Vector<engine::AInstanceManager*> index_;
+
+  // managers registered with other keys, frozen after build
+  engine::FlatIndex<engine::AInstanceManager*> keyed_index_;
+
+  // max number of cached error contexts, protection from unlimited growth
+  static const size_t kMaxMisses = 1024;
+
+  // error contexts of not registered objects by (type, key), the core holds
+  // one reference of each
+  std::mutex misses_mutex_;
+  engine::FlatIndex<engine::AContext*> misses_;
+  Vector<std::unique_ptr<engine::AContext, void (*)(engine::AContext*)>>
+      miss_contexts_;
 };
 
 // Implementation
 
+template <typename T>
+inline engine::PtrHolder<engine::BaseContext<T>> Core::GetContext() noexcept {
+  // the object is the root of a new tree, even if it is got by the creator
+  // of another object
+  engine::ArenaScope arena_scope(nullptr);
+  engine::SuspendedResolutionScope resolution_scope;
+  return GetContext<T>(Find(TypeId<T>()), engine::DEFAULT_KEY);
+}
+
 template <typename T>
 inline engine::PtrHolder<engine::BaseContext<T>> Core::GetContext(
-    const std::string& key) noexcept {
-  std::string type_key = TypeKey<T>(key);
-  const auto it = index_.find(type_key);
-  if (it == index_.end()) {
-    std::string error = "Type: " + type_key + " is not registered";
-    engine::PtrHolder<engine::ErrorContext<T>> error_context =
-        engine::MakePtrHolder<engine::ErrorContext<T>>(error);
-    return error_context;
+    const Key& key) noexcept {
+  engine::ArenaScope arena_scope(nullptr);
+  engine::SuspendedResolutionScope resolution_scope;
+  return GetContext<T>(Find(TypeId<T>(), key), key);
+}
+
+template <typename T>
+inline engine::PtrHolder<engine::BaseContext<T>> Core::GetContext(
+    engine::AInstanceManager* manager, const Key& key) noexcept {
+  if (manager == nullptr) {
+    return NotRegistered<T>(key);
   }
 
   engine::BaseInstanceManager<T>* instance_manager =
-      reinterpret_cast<engine::BaseInstanceManager<T>*>(it->second.Get());
+      static_cast<engine::BaseInstanceManager<T>*>(manager);
   return instance_manager->Get();
 }
 
 template <typename T>
-UPtr<T> Core::Get(const std::string& key) noexcept {
-  engine::PtrHolder<engine::BaseContext<T>> ptr_holder = GetContext<T>(key);
-  UPtr<T> uptr(std::move(ptr_holder));
-  return std::move(uptr);
+inline engine::PtrHolder<engine::BaseContext<T>> Core::NotRegistered(
+    const Key& key) noexcept {
+  const uint32_t type_id = TypeId<T>();
+  std::lock_guard<std::mutex> lock(misses_mutex_);
+
+  typedef engine::CountedContext<engine::ErrorContext<T>> MissContext;
+  engine::AContext* context = misses_.Find(type_id, key.Data(), key.Size());
+  if (context != nullptr) {
+    return static_cast<MissContext*>(context)->AddRef();
+  }
+
+  const engine::ErrorCode code = engine::ErrorCode::kNotRegistered;
+  if (miss_contexts_.size() >= kMaxMisses) {
+    engine::PtrHolder<engine::ErrorContext<T>> error_context =
+        engine::MakeResourceContext<engine::ErrorContext<T>>(
+            resource_, code, nullptr, TypeKey<T>(key));
+    if (error_context.Get() == nullptr) {
+      return engine::NoMemoryContext<T>();
+    }
+
+    return error_context;
+  }
+
+  MissContext* error_context = engine::NewInResource<MissContext>(
+      resource_, resource_, code, nullptr, TypeKey<T>(key));
+  if (error_context == nullptr) {
+    return engine::NoMemoryContext<T>();
+  }
+
+  // the core keeps the first reference, the allocator of the resource
+  // throws if there is no memory, then the error is not cached
+  try {
+    miss_contexts_.emplace_back(error_context, &MissContext::Free);
+  } catch (const std::bad_alloc&) {
+    return error_context;
+  }
+
+  misses_.Insert(type_id, key.Data(), key.Size(), error_context);
+  return error_context->AddRef();
+}
+
+template <typename T>
+inline engine::PtrHolder<engine::BaseContext<T>> Core::GetContext(
+    const Handle<T>& handle) noexcept {
+  return engine::GetContext<T>(handle);
+}
+
+template <typename T>
+inline Handle<T> Core::Resolve() const noexcept {
+  return Handle<T>(
+      static_cast<engine::BaseInstanceManager<T>*>(Find(TypeId<T>())));
+}
+
+template <typename T>
+inline Handle<T> Core::Resolve(const Key& key) const noexcept {
+  return Handle<T>(
+      static_cast<engine::BaseInstanceManager<T>*>(Find(TypeId<T>(), key)));
+}
+
+template <typename T>
+inline bool Core::Contains(const Key& key) const noexcept {
+  return Find(TypeId<T>(), key) != nullptr;
+}
+
+template <typename T>
+inline UPtr<T> Core::TryGet(const Key& key) noexcept {
+  engine::AInstanceManager* manager = Find(TypeId<T>(), key);
+  if (manager == nullptr) {
+    return UPtr<T>(engine::PtrHolder<engine::BaseContext<T>>(nullptr));
+  }
+
+  engine::ArenaScope arena_scope(nullptr);
+  engine::SuspendedResolutionScope resolution_scope;
+  return UPtr<T>(GetContext<T>(manager, key));
+}
+
+inline void Core::TrimCache() noexcept {
+  for (engine::PtrHolder<engine::AInstanceManager>& manager : managers_) {
+    manager->TrimCache();
+  }
+}
+
+inline engine::AInstanceManager* Core::Find(uint32_t type_id) const noexcept {
+  if (type_id >= index_.size()) {
+    return nullptr;
+  }
+
+  return index_[type_id];
+}
+
+inline engine::AInstanceManager* Core::Find(
+    uint32_t type_id, const Key& key) const noexcept {
+  if (key.IsDefault()) {
+    return Find(type_id);
+  }
+
+  if (key.IsReserved()) {
+    return nullptr;  // the string would be taken for a number key
+  }
+
+  return keyed_index_.Find(type_id, key.Data(), key.Size());
+}
+
+template <typename T>
+UPtr<T> Core::Get() noexcept {
+  return UPtr<T>(GetContext<T>());
+}
+
+template <typename T>
+UPtr<T> Core::Get(const Key& key) noexcept {
+  return UPtr<T>(GetContext<T>(key));
+}
+
+template <typename T>
+UPtr<T> Core::Get(const Handle<T>& handle) noexcept {
+  return UPtr<T>(GetContext<T>(handle));
 }
 
 namespace engine {
 
+/// @brief Function helper for access to Core (forward declaration)
+/// @tparam T type of managed object
+/// @param core [in] pointer to core
+/// @return unique_ptr with BaseContext instance of managed object
+template <typename T>
+inline PtrHolder<BaseContext<T>> GetContext(
+    cpptoolkit::factory::Core* core) noexcept {
+  return core->GetContext<T>();
+}
+
 /// @brief Function helper for access to Core (forward declaration)
 /// @tparam T type of managed object
 /// @param core [in] pointer to core
@@ -102,10 +372,63 @@ namespace engine {
 /// @return unique_ptr with BaseContext instance of managed object
 template <typename T>
 inline PtrHolder<BaseContext<T>> GetContext(
-    cpptoolkit::factory::Core* core, const std::string& key) noexcept {
+    cpptoolkit::factory::Core* core, const Key& key) noexcept {
   return core->GetContext<T>(key);
 }
 
+/// @brief Function helper for access to Core (forward declaration), gets
+/// the dependency which is a part of the current tree and shares its arena
+/// @tparam T type of managed object
+/// @param core [in] pointer to core
+/// @return unique_ptr with BaseContext instance of managed object
+template <typename T>
+inline PtrHolder<BaseContext<T>> ResolveContext(
+    cpptoolkit::factory::Core* core) noexcept {
+  Handle<T> handle = core->Resolve<T>();
+  if (!handle.IsValid()) {
+    return core->GetContext<T>();  // the error of not registered type
+  }
+
+  return ResolveContext<T>(handle);
+}
+
+/// @brief Function helper for access to Core (forward declaration), gets
+/// the dependency which is a part of the current tree and shares its arena
+/// @tparam T type of managed object
+/// @param core [in] pointer to core
+/// @param key [in] unique key for a given object type
+/// @return unique_ptr with BaseContext instance of managed object
+template <typename T>
+inline PtrHolder<BaseContext<T>> ResolveContext(
+    cpptoolkit::factory::Core* core, const Key& key) noexcept {
+  Handle<T> handle = core->Resolve<T>(key);
+  if (!handle.IsValid()) {
+    return core->GetContext<T>(key);  // the error of not registered type
+  }
+
+  return ResolveContext<T>(handle);
+}
+
+/// @brief Function helper for access to Core (forward declaration)
+/// @tparam T type of managed object
+/// @param core [in] pointer to core
+/// @return Handle of the object registered with the default key
+template <typename T>
+inline Handle<T> GetHandle(cpptoolkit::factory::Core* core) noexcept {
+  return core->Resolve<T>();
+}
+
+/// @brief Function helper for access to Core (forward declaration)
+/// @tparam T type of managed object
+/// @param core [in] pointer to core
+/// @param key [in] unique key for a given object type
+/// @return Handle of the object registered with the key
+template <typename T>
+inline Handle<T> GetHandle(cpptoolkit::factory::Core* core,
+                           const Key& key) noexcept {
+  return core->Resolve<T>(key);
+}
+
 }  // namespace engine
 
 }  // namespace factory
@@ -30,6 +30,12 @@
 #ifndef CPP_TOOL_KIT_FACTORY_CORE_EXTENSION_H_
 #define CPP_TOOL_KIT_FACTORY_CORE_EXTENSION_H_
 
+#include <algorithm>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "core.h"
 
 namespace cpptoolkit {
@@ -39,7 +45,11 @@ namespace engine {
 /// @brief Extends Core class provides registration of instance manager in Core
 class CoreExtension : public cpptoolkit::factory::Core {
  public:
-  CoreExtension() = default;
+  /// @brief Create CoreExtension
+  /// @param resource [in] source of memory for internal structures
+  explicit CoreExtension(
+      MemoryResource* resource = NewDeleteResource()) noexcept
+      : Core(resource){};
   virtual ~CoreExtension() = default;
 
   /// @brief Get last error description
@@ -51,21 +61,247 @@ class CoreExtension : public cpptoolkit::factory::Core {
   /// @param manager [in] instance manager
   /// @return Operation result
   bool Add(PtrHolder<AInstanceManager>&& mgr) noexcept {
-    const std::string& type_key = mgr->TypeKey();
+    if (keyed_index_.IsFrozen()) {
+      error_ = "Type: " + mgr->TypeKey() + " registration is closed";
+      return false;
+    }
+
+    const uint32_t type_id = mgr->TypeId();
+    const std::string& key = mgr->Key();
+    const bool is_default = key == DEFAULT_KEY;
+    const bool is_registered =
+        is_default ? type_id < index_.size() && index_[type_id] != nullptr
+                   : keyed_index_.Find(type_id, key.data(), key.size()) !=
+                         nullptr;
+    if (is_registered) {
+      error_ = "Type: " + mgr->TypeKey() + " already registered";
+      return false;
+    }
+
+    // the allocator of the resource throws if there is no memory, reserve
+    // the place for the manager before it is added to the index
+    bool is_added = false;
+    try {
+      if (managers_.size() == managers_.capacity()) {
+        managers_.reserve(managers_.size() * 2 + 1);
+      }
+
+      if (is_default && index_.size() <= type_id) {
+        index_.resize(type_id + 1, nullptr);
+      }
+
+      is_added = true;
+    } catch (const std::bad_alloc&) {
+    }
+
+    if (is_added) {
+      if (is_default) {
+        index_[type_id] = mgr.Get();
+      } else {
+        is_added =
+            keyed_index_.Insert(type_id, key.data(), key.size(), mgr.Get());
+      }
+    }
 
-    if (index_.count(type_key) == 1) {
-      error_ = "Type: " + type_key + " already registered";
+    if (!is_added) {
+      error_ = "Type: " + mgr->TypeKey() + " no memory for registration";
       return false;
     }
 
-    index_.emplace(type_key, std::move(mgr));
+    managers_.push_back(std::move(mgr));  // the memory is reserved
     return true;
   };
 
+  /// @brief Close registration, compact the index for fast access and bind
+  /// creators to managers of their dependencies. If there are objects shared
+  /// in resolution, every creation opens the resolution scope
+  void Freeze() noexcept {
+    keyed_index_.Freeze();
+    try {
+      index_.shrink_to_fit();
+    } catch (const std::bad_alloc&) {
+    }
+
+    bool shares = false;
+    for (auto& manager : managers_) {
+      manager->Compile();
+      shares = shares || manager->SharesInResolution();
+    }
+
+    if (shares) {
+      for (auto& manager : managers_) {
+        manager->OpenResolutionScope();
+      }
+    }
+  };
+
+  /// Check that declared dependencies have no cycles, call it after
+  /// 'Freeze()'. Objects registered with lambdas have no declared
+  /// dependencies, their cycles are found on creation. Without cycles the
+  /// topological order of the search gives the resolution plans
+  /// @return false if there is a cycle, check 'LastError()'
+  bool CheckCycles() noexcept;
+
  private:
+  /// @brief Implementation of 'CheckCycles()'
+  /// @return false if there is a cycle
+  /// @throw std::bad_alloc if there is no memory for the search
+  bool CheckCyclesOrThrow();
+
+  /// @brief Build resolution plans of the objects created from the contexts
+  /// of their dependencies. The plan of the object is the plans of its
+  /// dependencies, then the object, so the tree is created in one loop.
+  /// Only the trees of declared dependencies are planned, a lambda could get
+  /// any object on creation. Objects shared in resolution need the scope of
+  /// the tree, so there are no plans if they exist
+  /// @param order [in] indices of managers, the dependencies are before
+  /// the objects
+  void BuildPlans(const std::vector<size_t>& order) noexcept;
+
   std::string error_;
 };
 
+// Implementation
+
+inline bool CoreExtension::CheckCycles() noexcept {
+  try {
+    return CheckCyclesOrThrow();
+  } catch (const std::bad_alloc&) {
+    return true;  // the cycles are found on creation, there are no plans
+  }
+}
+
+inline bool CoreExtension::CheckCyclesOrThrow() {
+  std::unordered_map<AInstanceManager*, size_t> indices;
+  for (size_t i = 0; i < managers_.size(); ++i) {
+    indices[managers_[i].Get()] = i;
+  }
+
+  enum State : uint8_t { kNew, kInProgress, kDone };
+  std::vector<State> states(managers_.size(), kNew);
+  std::vector<std::pair<size_t, size_t>> path;  // manager, next dependency
+  std::vector<size_t> order;  // topological order, dependencies are first
+
+  for (size_t root = 0; root < managers_.size(); ++root) {
+    if (states[root] != kNew) {
+      continue;
+    }
+
+    // depth first search without recursion, the path is the chain of
+    // dependencies in progress
+    states[root] = kInProgress;
+    path.emplace_back(root, 0);
+    while (!path.empty()) {
+      AInstanceManager* manager = managers_[path.back().first].Get();
+      const size_t next = path.back().second++;
+      if (next == manager->DeclaredDependencyCount()) {
+        states[path.back().first] = kDone;
+        order.push_back(path.back().first);
+        path.pop_back();
+        continue;
+      }
+
+      AInstanceManager* dependency = manager->DeclaredDependency(next);
+      if (dependency == nullptr) {
+        continue;  // not registered, the error is on creation
+      }
+
+      const size_t index = indices[dependency];
+      if (states[index] == kNew) {
+        states[index] = kInProgress;
+        path.emplace_back(index, 0);
+      } else if (states[index] == kInProgress) {
+        error_ = "Cyclic dependency: ";
+        size_t i = 0;
+        while (path[i].first != index) {
+          ++i;
+        }
+        for (; i < path.size(); ++i) {
+          error_ += managers_[path[i].first]->TypeKey() + " -> ";
+        }
+        error_ += dependency->TypeKey();
+        return false;
+      }
+    }
+  }
+
+  BuildPlans(order);
+  return true;
+}
+
+inline void CoreExtension::BuildPlans(
+    const std::vector<size_t>& order) noexcept {
+  for (auto& manager : managers_) {
+    if (manager->SharesInResolution()) {
+      return;
+    }
+  }
+
+  std::unordered_map<AInstanceManager*, size_t> indices;
+  for (size_t i = 0; i < managers_.size(); ++i) {
+    indices[managers_[i].Get()] = i;
+  }
+
+  // the object is closed if the tree of its declared dependencies is known
+  std::vector<bool> is_closed(managers_.size(), false);
+  std::vector<std::vector<PlanStep>> plans(managers_.size());
+  std::vector<size_t> depths(managers_.size(), 0);  // max pending contexts
+  try {
+    for (size_t index : order) {
+      AInstanceManager* manager = managers_[index].Get();
+      if (!manager->DeclaresDependencies()) {
+        continue;
+      }
+
+      const size_t count = manager->DeclaredDependencyCount();
+      bool is_closed_tree = true;
+      for (size_t i = 0; i < count && is_closed_tree; ++i) {
+        AInstanceManager* dependency = manager->DeclaredDependency(i);
+        is_closed_tree =
+            dependency != nullptr && is_closed[indices[dependency]];
+      }
+
+      is_closed[index] = is_closed_tree;
+      if (!is_closed_tree || !manager->IsPlannable() ||
+          count > PlanStep::kMaxPending) {
+        continue;
+      }
+
+      // the plan of the dependency is inlined if it fits the limits, else
+      // the dependency is created by its manager
+      std::vector<PlanStep>& plan = plans[index];
+      size_t depth = count;
+      for (size_t i = 0; i < count; ++i) {
+        AInstanceManager* dependency = manager->DeclaredDependency(i);
+        const size_t dependency_index = indices[dependency];
+        const std::vector<PlanStep>& dependency_plan = plans[dependency_index];
+        if (!dependency_plan.empty() &&
+            i + depths[dependency_index] <= PlanStep::kMaxPending &&
+            plan.size() + dependency_plan.size() + count - i <=
+                PlanStep::kMaxSteps) {
+          plan.insert(plan.end(), dependency_plan.begin(),
+                      dependency_plan.end());
+          depth = std::max(depth, i + depths[dependency_index]);
+        } else {
+          plan.push_back(PlanStep{dependency, 0, false});
+        }
+      }
+
+      plan.push_back(PlanStep{manager, static_cast<uint32_t>(count), true});
+      depths[index] = std::max<size_t>(depth, 1);
+    }
+  } catch (const std::bad_alloc&) {
+    return;  // the objects are created by their managers
+  }
+
+  // the plan without dependencies does not save anything
+  for (size_t i = 0; i < managers_.size(); ++i) {
+    if (plans[i].size() > 1) {
+      managers_[i]->SetPlan(plans[i].data(), plans[i].size());
+    }
+  }
+}
+
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
@@ -0,0 +1,88 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_FACTORY_H_
+#define CPP_TOOL_KIT_FACTORY_FACTORY_H_
+
+#include "handle.h"
+#include "tool/arena.h"
+#include "tool/resolution_scope.h"
+#include "u_ptr.h"
+
+namespace cpptoolkit {
+namespace factory {
+
+/// Creates instances of registered object, it is got by
+/// 'Resolver::GetFactory()' and kept by the object which creates many
+/// instances. The call goes directly to the instance manager, without
+/// lookup in Core. Every call is a new top-level resolution, even inside the
+/// creator of the object: the instance is not placed in the arena of the
+/// current tree and does not share objects with it. The factory is valid
+/// while the Core is alive.
+/// @tparam T type of managed object
+template <typename T>
+class Factory {
+ public:
+  /// @brief Create empty factory, it creates only errors
+  Factory() noexcept : manager_(nullptr){};
+
+  /// @brief Create factory
+  /// @param manager [in] instance manager of the object
+  explicit Factory(engine::BaseInstanceManager<T>* manager) noexcept
+      : manager_(manager){};
+
+  ///@brief Create instance of the object
+  ///@return UPtr with instance, check 'IsValid()'
+  UPtr<T> operator()() const noexcept;
+
+  ///@brief Check if the object was registered
+  ///@return Check result
+  bool IsValid() const noexcept { return manager_ != nullptr; };
+
+ private:
+  engine::BaseInstanceManager<T>* manager_;
+};
+
+// Implementation
+
+template <typename T>
+inline UPtr<T> Factory<T>::operator()() const noexcept {
+  if (manager_ == nullptr) {
+    return UPtr<T>(engine::GetContext<T>(Handle<T>()));  // the error
+  }
+
+  engine::ArenaScope arena_scope(nullptr);
+  engine::SuspendedResolutionScope resolution_scope;
+  return UPtr<T>(manager_->Get());
+}
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_FACTORY_H_
@@ -0,0 +1,122 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_HANDLE_H_
+#define CPP_TOOL_KIT_FACTORY_HANDLE_H_
+
+#include <string>
+
+#include "manager/base_instance_manager.h"
+#include "manager/context/error_context.h"
+#include "manager/context/shared_context.h"
+#include "tool/arena.h"
+#include "tool/common.h"
+#include "tool/resolution_scope.h"
+
+namespace cpptoolkit {
+namespace factory {
+
+/// @brief Pre-resolved access to registered object, allows to skip lookup
+/// in Core on every call 'Get(handle)'. The handle is valid while the Core
+/// is alive.
+/// @tparam T type of managed object
+template <typename T>
+class Handle {
+ public:
+  /// @brief Create empty handle
+  Handle() noexcept : manager_(nullptr){};
+
+  /// @brief Create handle
+  /// @param manager [in] instance manager of the object
+  explicit Handle(engine::BaseInstanceManager<T>* manager) noexcept
+      : manager_(manager){};
+
+  ///@brief Check if the object was registered
+  ///@return Check result
+  bool IsValid() const noexcept;
+
+  ///@brief Get instance manager of the object
+  ///@return Pointer to instance manager or nullptr
+  engine::BaseInstanceManager<T>* Manager() const noexcept;
+
+ private:
+  engine::BaseInstanceManager<T>* manager_;
+};
+
+// Implementation
+
+template <typename T>
+inline bool Handle<T>::IsValid() const noexcept {
+  return manager_ != nullptr;
+}
+
+template <typename T>
+inline engine::BaseInstanceManager<T>* Handle<T>::Manager() const noexcept {
+  return manager_;
+}
+
+namespace engine {
+
+/// @brief Get context with managed object over the handle, the object is the
+/// root of a new tree, it is not placed in the arena of the current tree and
+/// does not share objects with it
+/// @tparam T type of managed object
+/// @param handle [in] handle of registered object
+/// @return unique_ptr with BaseContext instance of managed object
+template <typename T>
+inline PtrHolder<BaseContext<T>> GetContext(const Handle<T>& handle) noexcept {
+  ArenaScope arena_scope(nullptr);
+  SuspendedResolutionScope resolution_scope;
+  return ResolveContext<T>(handle);
+}
+
+/// @brief Get context of the dependency over the handle, the dependency is a
+/// part of the current tree and shares its arena
+/// @tparam T type of managed object
+/// @param handle [in] handle of registered object
+/// @return unique_ptr with BaseContext instance of managed object
+template <typename T>
+inline PtrHolder<BaseContext<T>> ResolveContext(
+    const Handle<T>& handle) noexcept {
+  if (!handle.IsValid()) {
+    // the error is the same for all empty handles of the type
+    static SharedContext<ErrorContext<T>> error_context(
+        ErrorCode::kEmptyHandle, typeid(T).name());
+    return PtrHolder<BaseContext<T>>(&error_context);
+  }
+
+  return handle.Manager()->Get();
+}
+
+}  // namespace engine
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_HANDLE_H_
@@ -0,0 +1,203 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_LAZY_H_
+#define CPP_TOOL_KIT_FACTORY_LAZY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+#include "handle.h"
+#include "manager/context/dependency_container.h"
+
+namespace cpptoolkit {
+namespace factory {
+
+namespace engine {
+
+/// @brief Mutex which guards the dependencies of the parent when its lazy
+/// dependency is added, lazy dependencies of one parent use the same mutex.
+/// The dependency is created without it
+/// @param parent [in] dependencies of the object which owns lazy dependencies
+/// @return Reference to mutex
+inline std::mutex& LazyMutex(const DependencyContainer* parent) noexcept {
+  static const size_t kMutexCount = 16;
+  static std::mutex mutexes[kMutexCount];
+  const uintptr_t address = reinterpret_cast<uintptr_t>(parent);
+  return mutexes[(address / alignof(std::max_align_t)) % kMutexCount];
+}
+
+}  // namespace engine
+
+/// Dependency which is created on the first use, it is got by
+/// 'Resolver::GetLazy()' and kept by the object. The created dependency is
+/// owned by the context of the object, as other dependencies. If the
+/// dependency is never used it costs nothing. The first use is thread safe,
+/// the dependency is created once, other threads wait for it.
+/// @tparam T type of dependency object
+template <typename T>
+class Lazy {
+ public:
+  /// @brief Create empty lazy dependency, its use gives the error
+  Lazy() noexcept
+      : manager_(nullptr),
+        parent_(nullptr),
+        instance_(nullptr),
+        error_(EmptyError()),
+        is_created_(true){};
+
+  /// @brief Create lazy dependency
+  /// @param manager [in] instance manager of the dependency
+  /// @param parent [in] dependencies of the object which owns the dependency
+  Lazy(engine::BaseInstanceManager<T>* manager,
+       engine::DependencyContainer* parent) noexcept
+      : manager_(manager),
+        parent_(parent),
+        instance_(nullptr),
+        error_(nullptr),
+        is_created_(false){};
+
+  /// @brief Move lazy dependency to the object, before the first use. The
+  /// other instance becomes empty
+  /// @param other [in] another instance
+  Lazy(Lazy<T>&& other) noexcept
+      : manager_(other.manager_),
+        parent_(other.parent_),
+        instance_(other.instance_),
+        error_(other.error_),
+        is_created_(other.is_created_.load(std::memory_order_acquire)) {
+    other.manager_ = nullptr;
+    other.parent_ = nullptr;
+    other.instance_ = nullptr;
+    other.error_ = EmptyError();
+    other.is_created_.store(true, std::memory_order_release);
+  };
+
+  // Ban copy, the dependency is created once
+  Lazy(const Lazy<T>& other) = delete;
+  Lazy<T>& operator=(const Lazy<T>& other) = delete;
+
+  ///@brief Get dependency, it is created on the first call
+  ///@return Pointer to dependency or nullptr in error case
+  T* Get() noexcept;
+
+  ///@brief Provides access to public methods and fields of dependency
+  T* operator->() noexcept { return Get(); };
+
+  ///@brief Check if the dependency was created properly, it is created on
+  ///the first call
+  ///@return Check result
+  bool IsValid() noexcept { return Get() != nullptr; };
+
+  ///@brief Get description if the dependency was created with error
+  ///@return Error description
+  std::string Error() noexcept;
+
+ private:
+  void Create() noexcept;
+
+  static const engine::ErrorInfo* EmptyError() noexcept;
+
+ private:
+  engine::BaseInstanceManager<T>* manager_;
+  engine::DependencyContainer* parent_;
+  T* instance_;
+  const engine::ErrorInfo* error_;  // owned by the context of dependency
+  std::atomic<bool> is_created_;    // publishes the instance and the error
+  std::mutex mutex_;                // guards the creation
+};
+
+// Implementation
+
+template <typename T>
+inline T* Lazy<T>::Get() noexcept {
+  if (!is_created_.load(std::memory_order_acquire)) {
+    Create();
+  }
+
+  return instance_;
+}
+
+template <typename T>
+inline std::string Lazy<T>::Error() noexcept {
+  Get();
+  if (error_ == nullptr) {
+    return std::string();
+  }
+
+  return error_->Message();
+}
+
+template <typename T>
+void Lazy<T>::Create() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_created_.load(std::memory_order_relaxed)) {
+    return;  // another thread was first
+  }
+
+  // the dependency is the root of a new tree, it is not placed in the arena
+  // of the tree which is created now. The parent does not use the arena of
+  // the current thread either, its tree is already created
+  engine::PtrHolder<engine::BaseContext<T>> context =
+      engine::GetContext<T>(Handle<T>(manager_));
+
+  T* instance = context->GetInstance();
+  const engine::ErrorInfo* error = context->GetErrorInfo();
+  bool is_pushed = false;
+  {
+    std::lock_guard<std::mutex> parent_lock(engine::LazyMutex(parent_));
+    is_pushed = parent_->Push(std::move(context));
+  }
+
+  if (!is_pushed) {
+    instance = nullptr;  // the context is deleted
+    error = engine::ErrorInfo::NoMemory();
+  }
+
+  instance_ = error == nullptr ? instance : nullptr;
+  error_ = error;
+  is_created_.store(true, std::memory_order_release);
+}
+
+template <typename T>
+inline const engine::ErrorInfo* Lazy<T>::EmptyError() noexcept {
+  // the error is the same for all empty lazy dependencies of the type
+  static const engine::ErrorInfo error(engine::ErrorCode::kEmptyHandle,
+                                       typeid(T).name());
+  return &error;
+}
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_LAZY_H_
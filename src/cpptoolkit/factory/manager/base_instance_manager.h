@@ -30,60 +30,365 @@
 #ifndef CPP_TOOL_KIT_FACTORY_BASE_INSTANCE_MANAGER_H_
 #define CPP_TOOL_KIT_FACTORY_BASE_INSTANCE_MANAGER_H_
 
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <string>
 
+#include "../tool/arena.h"
+#include "../tool/common.h"
+#include "../tool/creation_frame.h"
+#include "../tool/memory_resource.h"
+#include "../tool/resolution_scope.h"
+#include "../tool/slab.h"
 #include "context/context.h"
 #include "context/error_context.h"
+#include "context/resource_context.h"
+#include "context/shared_context.h"
+#include "context/slab_context.h"
 #include "resolver.h"
 
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
+class AInstanceManager;
+
+/// @brief Step of the resolution plan of the object tree. The steps are in
+/// topological order, the dependencies are before the object, so the plan is
+/// executed in one loop with the stack of pending contexts
+struct PlanStep {
+  // max number of steps in the plan
+  static const size_t kMaxSteps = 256;
+
+  // max number of contexts pending on the stack
+  static const size_t kMaxPending = 16;
+
+  AInstanceManager* manager;
+
+  // number of pending contexts moved to the object
+  uint32_t dependency_count;
+
+  // true - the object is created from the pending contexts of its
+  // dependencies, false - the manager creates the object by itself
+  bool is_planned;
+};
+
 /// @brief Base class for all object managers
 class AInstanceManager {
  public:
   virtual ~AInstanceManager() noexcept = default;
 
-  /// @brief Unique key for current manager
+  /// @brief Delete the manager, a manager created in the memory resource
+  /// returns the memory to it
+  virtual void Release() noexcept { delete this; };
+
+  /// @brief Human readable key for current manager
   /// @return Key
   virtual const std::string& TypeKey() noexcept = 0;
+
+  /// @brief Number of the managed object type
+  /// @return Type number
+  virtual uint32_t TypeId() noexcept = 0;
+
+  /// @brief Key of the managed object registration
+  /// @return Key
+  virtual const std::string& Key() noexcept = 0;
+
+  /// @brief Set max number of cached memory blocks for contexts
+  /// @param capacity [in] number of blocks, 0 disables the cache
+  virtual void SetCacheCapacity(size_t capacity) noexcept = 0;
+
+  /// @brief Delete cached memory blocks of contexts
+  virtual void TrimCache() noexcept = 0;
+
+  /// @brief Bind the creator to managers of its dependencies, it is called
+  /// once when the registration is closed
+  virtual void Compile() noexcept {};
+
+  /// @brief Number of dependencies declared on registration, they are known
+  /// after 'Compile()'
+  /// @return Number of dependencies, 0 if they are not declared
+  virtual size_t DeclaredDependencyCount() noexcept { return 0; };
+
+  /// @brief Get manager of declared dependency
+  /// @param index [in] index of dependency
+  /// @return Manager or nullptr if the dependency is not registered
+  virtual AInstanceManager* DeclaredDependency(size_t /*index*/) noexcept {
+    return nullptr;
+  };
+
+  /// @brief Check if the object is created once in the tree of one
+  /// resolution
+  /// @return Check result
+  virtual bool SharesInResolution() noexcept { return false; };
+
+  /// @brief Open the resolution scope on creation of the object, it is
+  /// called when the Core has objects shared in resolution
+  virtual void OpenResolutionScope() noexcept = 0;
+
+  /// @brief Check if the creator declares all dependencies of the object, so
+  /// it does not get other objects on creation
+  /// @return Check result
+  virtual bool DeclaresDependencies() noexcept { return false; };
+
+  /// @brief Check if the object can be created from the contexts of its
+  /// declared dependencies by the resolution plan
+  /// @return Check result
+  virtual bool IsPlannable() noexcept { return false; };
+
+  /// @brief Set the resolution plan of the object tree, it is called once
+  /// when the registration is closed
+  /// @param steps [in] steps in topological order, the last one is the object
+  /// @param count [in] number of steps
+  virtual void SetPlan(const PlanStep* /*steps*/, size_t /*count*/) noexcept {};
+
+  /// @brief Get context of the object with erased type, the step of the plan
+  /// which is not planned
+  /// @return Context of the object
+  virtual PtrHolder<AContext> GetErased() noexcept = 0;
+
+  /// @brief Create the object from the contexts of its declared dependencies,
+  /// the planned step of the plan
+  /// @param dependencies [in] contexts in the order of the dependencies, they
+  /// are moved to the object
+  /// @return Context of the object
+  virtual PtrHolder<AContext> CreateFromPlan(
+      AContext** dependencies) noexcept = 0;
 };
 
-/// @brief Base object for instance managers
+/// @brief Release the pending contexts which are not moved to the object
+/// @param contexts [in] contexts
+/// @param count [in] number of contexts
+inline void ReleaseContexts(AContext** contexts, size_t count) noexcept {
+  for (size_t i = 0; i < count; ++i) {
+    PtrHolder<AContext> context(contexts[i]);
+  }
+}
+
+/// @brief Execute the resolution plan of the object tree without recursion
+/// @tparam T type of the object, the last step of the plan
+/// @param steps [in] steps in topological order
+/// @param count [in] number of steps
+/// @return Context of the object
+template <typename T>
+inline PtrHolder<BaseContext<T>> RunPlan(const PlanStep* steps,
+                                         size_t count) noexcept {
+  AContext* pending[PlanStep::kMaxPending];
+  size_t size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const PlanStep& step = steps[i];
+    if (step.is_planned) {
+      size -= step.dependency_count;
+      pending[size] = step.manager->CreateFromPlan(pending + size).Relese();
+    } else {
+      pending[size] = step.manager->GetErased().Relese();
+    }
+    ++size;
+  }
+
+  return PtrHolder<BaseContext<T>>(static_cast<BaseContext<T>*>(pending[0]));
+}
+
+/// @brief Type erased function for create instance of managed object, the
+/// default type of creator of instance managers
+/// @tparam T type of managed object
+template <typename T>
+using CreateFunction = std::function<T*(cpptoolkit::factory::Resolver&)>;
+
+/// @brief Bind the creator to managers of its dependencies. A creator with
+/// unknown dependencies (a lambda, a function) gets them on every call
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @param core [in] pointer to the core_ with registered objects
+template <typename F>
+inline void CompileCreator(F& /*create*/,
+                           cpptoolkit::factory::Core* /*core*/) noexcept {}
+
+/// @brief Number of dependencies declared by the creator
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @return Number of dependencies, 0 if they are not known
+template <typename F>
+inline size_t CreatorDependencyCount(const F& /*create*/) noexcept {
+  return 0;
+}
+
+/// @brief Get manager of dependency declared by the creator
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @param index [in] index of dependency
+/// @return Manager or nullptr if the dependency is not registered
+template <typename F>
+inline AInstanceManager* CreatorDependency(const F& /*create*/,
+                                           size_t /*index*/) noexcept {
+  return nullptr;
+}
+
+/// @brief Check if the creator declares all dependencies of the object
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @return false for a creator with unknown dependencies
+template <typename F>
+inline bool CreatorDeclaresDependencies(const F& /*create*/) noexcept {
+  return false;
+}
+
+/// @brief Check if the creator makes the object from the contexts of its
+/// dependencies, see 'CreateFromContexts()'
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @return false for a creator with unknown dependencies
+template <typename F>
+inline bool CreatorCreatesFromContexts(const F& /*create*/) noexcept {
+  return false;
+}
+
+/// @brief Create the object from the contexts of its declared dependencies,
+/// it is not called for a creator with unknown dependencies
+/// @tparam F type of creator
+/// @param create [in] creator of instance
+/// @param resolver [in] resolver of the object context
+/// @param dependencies [in] contexts in the order of the dependencies
+/// @return Pointer to the object
+template <typename F>
+inline std::nullptr_t CreateFromContexts(
+    F& /*create*/, cpptoolkit::factory::Resolver& /*resolver*/,
+    AContext** /*dependencies*/) noexcept {
+  return nullptr;
+}
+
+/// @brief Base object for instance managers. The creator of the instance is
+/// kept by derived managers as their template parameter, so it is called
+/// directly and can be inlined into 'Get()'
 /// @tparam T type of managed object
 template <typename T>
 class BaseInstanceManager : public AInstanceManager {
  public:
   /// @brief Create BaseInstanceManager
-  /// @param class_name_key [in] unique key for current manager
-  /// @param create [in] function for create instance of managed object
+  /// @param key [in] unique key for a given object type
   /// @param core [in] pointer to the core_ with registered objects
-  BaseInstanceManager(
-      const std::string class_name_key,
-      std::function<T*(cpptoolkit::factory::Resolver&)>&& create,
-      cpptoolkit::factory::Core* core) noexcept
-      : class_name_key_(class_name_key),
-        create_(std::move(create)),
-        core_(core){};
+  /// @param resource [in] source of memory for contexts
+  BaseInstanceManager(const std::string key, cpptoolkit::factory::Core* core,
+                      MemoryResource* resource = NewDeleteResource()) noexcept
+      : core_(core),
+        resource_(resource),
+        key_(key),
+        class_name_key_(cpptoolkit::factory::TypeKey<T>(key)),
+        null_error_(NewInResource<SharedError>(resource, resource,
+                                               ErrorCode::kCreateReturnedNull,
+                                               class_name_key_.c_str())),
+        unknown_error_(NewInResource<SharedError>(
+            resource, resource, ErrorCode::kCreateUnknownException,
+            class_name_key_.c_str())),
+        cycle_error_(NewInResource<SharedError>(resource, resource,
+                                                ErrorCode::kCyclicDependency,
+                                                class_name_key_.c_str())),
+        depth_error_(NewInResource<SharedError>(resource, resource,
+                                                ErrorCode::kTooDeep,
+                                                class_name_key_.c_str())),
+        context_slab_(
+            Slab::Create(sizeof(SlabContext<Context<T>>), resource)),
+        instance_slab_(nullptr),
+        dependency_count_(0),
+        open_scope_(false){};
+
+  virtual ~BaseInstanceManager() noexcept {
+    Slab::Detach(context_slab_);
+    Slab::Detach(instance_slab_.load(std::memory_order_acquire));
+  };
 
   /// @brief Create instance of managed object and save it to the context
   /// @return Context with instance of managed object
   virtual PtrHolder<BaseContext<T>> Get() noexcept = 0;
 
   const std::string& TypeKey() noexcept override;
+  uint32_t TypeId() noexcept override;
+  const std::string& Key() noexcept override;
+  void SetCacheCapacity(size_t capacity) noexcept override;
+  void TrimCache() noexcept override;
+  void OpenResolutionScope() noexcept override { open_scope_ = true; };
+  PtrHolder<AContext> GetErased() noexcept override { return Get(); };
+
+  /// @brief The manager which is not plannable creates the object by itself
+  PtrHolder<AContext> CreateFromPlan(
+      AContext** dependencies) noexcept override {
+    ReleaseContexts(dependencies, DeclaredDependencyCount());
+    return Get();
+  };
 
  protected:
-  inline void Create(Context<T>* context) noexcept;
+  /// @brief Create context for new instance, the memory is taken from
+  /// the cache of the manager
+  /// @return Empty context
+  PtrHolder<Context<T>> MakeContext() noexcept;
+
+  /// @brief Create instance and its dependencies
+  /// @tparam F type of creator, callable as 'T*(Resolver&)'
+  /// @param context [in] context for the instance
+  /// @param create [in] creator of the instance
+  /// @param arena [in] arena of the dependency tree or nullptr, the
+  /// dependencies are created in it
+  template <typename F>
+  inline void Create(Context<T>* context, F& create,
+                     Arena* arena = nullptr) noexcept;
+
+  /// @brief Check if the object is in progress in the chain of the current
+  /// thread, the chain continues over tasks of parallel resolution
+  /// @return Check result
+  bool IsInProgress() const noexcept {
+    return CreationFrame::IsInProgress(this);
+  };
+
+  typedef CountedContext<ErrorContext<T>> SharedError;
+
+  /// @brief Get reference to the error shared by failed creations
+  /// @param error [in] error of the manager, nullptr if there was no memory
+  /// @return Error context
+  static PtrHolder<ErrorContext<T>> ShareError(
+      const PtrHolder<SharedError>& error) noexcept;
 
  private:
-  inline void AddError(Context<T>* context, std::string& error) noexcept;
+  inline void AddError(Context<T>* context, const char* error) noexcept;
+
+  /// @brief Create the slab for contexts with the storage for the instance
+  /// and dependencies
+  /// @param size [in] size of the storage
+  void LearnStorageSize(size_t size) noexcept;
+
+  // offset of the instance storage in the memory block of the context
+  static const size_t kStorageOffset =
+      (sizeof(SlabContext<Context<T>>) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  // max size of the storage of the context
+  static const size_t kMaxStorageSize = 1024;
 
  protected:
-  std::function<T*(cpptoolkit::factory::Resolver&)> create_;
   cpptoolkit::factory::Core* core_;
+  MemoryResource* resource_;
+  std::string key_;
   std::string class_name_key_;
+
+  // errors without details, shared by all failed creations, they live while
+  // they are referenced
+  PtrHolder<SharedError> null_error_;
+  PtrHolder<SharedError> unknown_error_;
+  PtrHolder<SharedError> cycle_error_;
+  PtrHolder<SharedError> depth_error_;
+
+  Slab* context_slab_;  // memory for Context<T>, nullptr if there is no memory
+
+  // memory for Context<T> with the instance (created by
+  // 'Resolver::Construct()') and dependencies, created after the first
+  // successful creation
+  std::atomic<Slab*> instance_slab_;
+
+  // number of dependencies on the first successful creation
+  std::atomic<uint32_t> dependency_count_;
+
+  // the creation opens the resolution scope
+  bool open_scope_;
 };
 
 // Implementation
@@ -94,42 +399,163 @@ inline const std::string& BaseInstanceManager<T>::TypeKey() noexcept {
 }
 
 template <typename T>
-inline void BaseInstanceManager<T>::Create(Context<T>* context) noexcept {
+inline uint32_t BaseInstanceManager<T>::TypeId() noexcept {
+  return cpptoolkit::factory::TypeId<T>();
+}
+
+template <typename T>
+inline const std::string& BaseInstanceManager<T>::Key() noexcept {
+  return key_;
+}
+
+template <typename T>
+inline void BaseInstanceManager<T>::SetCacheCapacity(size_t capacity) noexcept {
+  if (context_slab_ != nullptr) {
+    context_slab_->SetCapacity(capacity);
+  }
+
+  Slab* instance_slab = instance_slab_.load(std::memory_order_acquire);
+  if (instance_slab != nullptr) {
+    instance_slab->SetCapacity(capacity);
+  }
+}
+
+template <typename T>
+inline void BaseInstanceManager<T>::TrimCache() noexcept {
+  if (context_slab_ != nullptr) {
+    context_slab_->Trim();
+  }
+
+  Slab* instance_slab = instance_slab_.load(std::memory_order_acquire);
+  if (instance_slab != nullptr) {
+    instance_slab->Trim();
+  }
+}
+
+template <typename T>
+inline PtrHolder<Context<T>> BaseInstanceManager<T>::MakeContext() noexcept {
+  Slab* instance_slab = instance_slab_.load(std::memory_order_acquire);
+  PtrHolder<Context<T>> context = MakeSlabContext<Context<T>>(
+      instance_slab != nullptr ? instance_slab : context_slab_);
+  if (context.Get() == nullptr) {
+    return context;
+  }
+
+  if (instance_slab != nullptr) {
+    char* block = reinterpret_cast<char*>(
+        static_cast<SlabContext<Context<T>>*>(context.Get()));
+    context->SetStorage(block + kStorageOffset,
+                        instance_slab->BlockSize() - kStorageOffset);
+  }
+
+  return context;
+}
+
+template <typename T>
+inline void BaseInstanceManager<T>::LearnStorageSize(size_t size) noexcept {
+  if (size > kMaxStorageSize ||
+      instance_slab_.load(std::memory_order_acquire) != nullptr) {
+    return;
+  }
+
+  Slab* slab = Slab::Create(kStorageOffset + size, resource_);
+  if (slab == nullptr) {
+    return;
+  }
+
+  if (context_slab_ != nullptr) {
+    slab->SetCapacity(context_slab_->Capacity());
+  }
+
+  Slab* expected = nullptr;
+  if (!instance_slab_.compare_exchange_strong(expected, slab,
+                                              std::memory_order_acq_rel)) {
+    Slab::Detach(slab);  // another thread was first
+  }
+}
+
+template <typename T>
+template <typename F>
+inline void BaseInstanceManager<T>::Create(Context<T>* context, F& create,
+                                           Arena* arena) noexcept {
+  CreationFrame frame(this);
+  if (frame.IsTooDeep()) {
+    context->Add(ShareError(depth_error_));
+    return;
+  }
+
+  if (frame.IsCycle()) {
+    context->Add(ShareError(cycle_error_));
+    return;
+  }
+
+  ArenaScope arena_scope(arena);
+  ResolutionScope resolution_scope(open_scope_);
+  const uint32_t dependency_count =
+      dependency_count_.load(std::memory_order_relaxed);
+  if (dependency_count != 0) {
+    context->ReserveDependencies(dependency_count);
+  }
+
   Resolver dependencyHelper(core_, context);
 
   try {
-    T* instance_ptr = create_(dependencyHelper);
+    T* instance_ptr = create(dependencyHelper);
     context->SetInstance(instance_ptr);
 
+    if (context->IsValid()) {
+      if (dependency_count == 0 && context->DependencyCount() != 0) {
+        uint32_t expected = 0;
+        dependency_count_.compare_exchange_strong(
+            expected, static_cast<uint32_t>(context->DependencyCount()),
+            std::memory_order_relaxed);
+      }
+
+      if (context->RequiredStorage() != 0) {
+        LearnStorageSize(context->RequiredStorage());
+      }
+    }
+
     if (instance_ptr == nullptr && context->IsValid()) {
-      std::string error = "Error on create instance: " + class_name_key_ +
-                          " 'Create' returned nullptr";
-      AddError(context, error);
+      context->Add(ShareError(null_error_));
       return;
     }
   } catch (std::exception& ex) {
     // If the context contains other error, then do not save current
     // exception
     if (context->IsValid()) {
-      std::string error = "Error on create instance: " + class_name_key_ +
-                          " Error: " + ex.what();
-      AddError(context, error);
+      AddError(context, ex.what());
     }
   } catch (...) {
     // The same behaviour for current case
     if (context->IsValid()) {
-      std::string error =
-          "Unknown error on create instance: " + class_name_key_;
-      AddError(context, error);
+      context->Add(ShareError(unknown_error_));
     }
   }
 }
 
+template <typename T>
+inline PtrHolder<ErrorContext<T>> BaseInstanceManager<T>::ShareError(
+    const PtrHolder<SharedError>& error) noexcept {
+  if (error.Get() == nullptr) {
+    return NoMemoryContext<T>();
+  }
+
+  return error->AddRef();
+}
+
 template <typename T>
 inline void BaseInstanceManager<T>::AddError(Context<T>* context,
-                                             std::string& error) noexcept {
+                                             const char* error) noexcept {
   PtrHolder<ErrorContext<T>> error_context =
-      MakePtrHolder<ErrorContext<T>>(error);
+      MakeResourceContext<ErrorContext<T>>(
+          resource_, ErrorCode::kCreateException, class_name_key_.c_str(),
+          error);
+  if (error_context.Get() == nullptr) {
+    context->Add(PtrHolder<ErrorContext<T>>(NoMemoryContext<T>()));
+    return;
+  }
+
   context->Add(std::move(error_context));
 }
 
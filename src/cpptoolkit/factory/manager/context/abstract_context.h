@@ -30,29 +30,110 @@
 #ifndef CPP_TOOL_KIT_FACTORY_ABSTRACT_CONTEXT_H_
 #define CPP_TOOL_KIT_FACTORY_ABSTRACT_CONTEXT_H_
 
+#include <cstdint>
 #include <string>
 
+#include "error_info.h"
+
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
-/// @brief Key for objects without key
-static const std::string DEFAULT_KEY = "default";
+/// @brief Kind of the context
+enum class ContextKind : uint8_t {
+
+  /// @brief Owns the instance and its dependencies
+  kOwning = 0,
+
+  /// @brief Refers to the instance which is owned by somebody else
+  kWeak = 1,
+
+  /// @brief Slot of the pool, the instance is returned to the pool
+  kPool = 2,
+
+  /// @brief Owns the error, has no instance
+  kError = 3,
+
+  /// @brief Shares the context of the instance by several consumers, the
+  /// last one deletes it
+  kRef = 4
+};
+
+class AContext;
+
+/// @brief Operations of the concrete context type, they are used only at the
+/// end of usage of the context
+struct ContextOps {
+  /// @brief Kind of the context
+  ContextKind kind;
+
+  /// @brief Destroy the context, the context which is owned by somebody else
+  /// (not by PtrHolder) is not deleted
+  void (*release)(AContext* context);
+};
+
+/// @brief Table of operations for the concrete context type
+/// @tparam C type of context with 'kKind' and static 'Free(AContext*)'
+template <typename C>
+struct ContextTable {
+  static const ContextOps kOps;
+};
 
-/// @brief Contains basic information about creation of managed object
+template <typename C>
+const ContextOps ContextTable<C>::kOps = {C::kKind, &C::Free};
+
+/// @brief Contains basic information about creation of managed object. The
+/// context has no virtual methods, the hot path (check of the error) reads
+/// the field, the concrete type is known only by the table of operations
 class AContext {
  public:
-  virtual ~AContext() noexcept = default;
-
   /// @brief Check is current dependency is valid
   /// @return Result of the checking
-  virtual bool IsValid() noexcept = 0;
+  bool IsValid() const noexcept { return error_ == nullptr; };
 
   /// @brief Get error description
   /// @return Error message
-  virtual std::string Error() noexcept = 0;
+  std::string Error() const noexcept;
+
+  /// @brief Get error, the message is not formatted
+  /// @return Pointer to the error or nullptr if there is no error
+  const ErrorInfo* GetErrorInfo() const noexcept { return error_; };
+
+  /// @brief Set error of the context
+  /// @param error [in] error, owned by an error context
+  void SetError(const ErrorInfo* error) noexcept { error_ = error; };
+
+  /// @brief Kind of the context
+  /// @return Kind
+  ContextKind Kind() const noexcept { return ops_->kind; };
+
+  /// @brief Destroy the context at the end of usage
+  void Release() noexcept { ops_->release(this); };
+
+ protected:
+  /// @brief Create context
+  /// @param ops [in] operations of the concrete type
+  explicit AContext(const ContextOps* ops) noexcept
+      : ops_(ops), error_(nullptr){};
+
+  /// @brief The context is destroyed only by 'Release()'
+  ~AContext() noexcept = default;
+
+ protected:
+  const ContextOps* ops_;   // set by the most derived type
+  const ErrorInfo* error_;  // error description, owned by an error context
 };
 
+// Implementation
+
+inline std::string AContext::Error() const noexcept {
+  if (error_ == nullptr) {
+    return std::string();
+  }
+
+  return error_->Message();
+}
+
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
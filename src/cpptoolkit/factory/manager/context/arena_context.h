@@ -0,0 +1,96 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_ARENA_CONTEXT_H_
+#define CPP_TOOL_KIT_FACTORY_ARENA_CONTEXT_H_
+
+#include <new>
+
+#include "../../tool/arena.h"
+#include "ptr_holder.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Context created in the arena of a dependency tree. The context of
+/// the root owns the arena and deletes it at the end of usage, other contexts
+/// are only destroyed
+/// @tparam C type of context
+template <typename C>
+class ArenaContext : public C {
+ public:
+  /// @brief Create context
+  /// @param owned_arena [in] arena for the root of the tree, nullptr for
+  /// other contexts
+  /// @param ...args [in] arguments for C constructor
+  template <typename... Args>
+  ArenaContext(Arena* owned_arena, Args&&... args) noexcept
+      : C(std::forward<Args>(args)...), owned_arena_(owned_arena) {
+    this->ops_ = &ContextTable<ArenaContext>::kOps;
+  };
+
+  /// @brief Destroy the context, the root deletes the arena
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    ArenaContext* self = static_cast<ArenaContext*>(context);
+    Arena* arena = self->owned_arena_;
+    self->~ArenaContext();
+    Arena::Destroy(arena);  // dependencies are already destroyed
+  };
+
+ private:
+  Arena* owned_arena_;
+};
+
+/// @brief Create context in the arena
+/// @tparam C type of context
+/// @tparam ...Args types of arguments for C
+/// @param arena [in] arena of the tree
+/// @param is_root [in] the context owns the arena
+/// @param ...args [in] arguments for C constructor
+/// @return PtrHolder with context or nullptr if there is no memory
+template <typename C, typename... Args>
+inline PtrHolder<C> MakeArenaContext(Arena* arena, bool is_root,
+                                     Args&&... args) noexcept {
+  void* block = arena->Allocate(sizeof(ArenaContext<C>),
+                                alignof(ArenaContext<C>));
+  if (block == nullptr) {
+    return PtrHolder<C>(nullptr);
+  }
+
+  return PtrHolder<C>(new (block) ArenaContext<C>(
+      is_root ? arena : nullptr, std::forward<Args>(args)...));
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_ARENA_CONTEXT_H_
@@ -41,13 +41,6 @@ namespace engine {
 template <typename T>
 class BaseContext : public AContext {
  public:
-  /// @brief Create BaseContext
-  /// @param is_valid context validation flag
-  BaseContext(bool is_valid) noexcept
-      : instance_ptr_(nullptr), is_valid_(is_valid){};
-
-  virtual ~BaseContext() noexcept {};
-
   /// @brief Set pointer to managed object
   /// @param instance_ptr pointer to managed object
   void SetInstance(T* instance_ptr) noexcept;
@@ -56,19 +49,22 @@ class BaseContext : public AContext {
   /// @return pointer to managed object
   T* GetInstance() noexcept;
 
-  bool IsValid() noexcept override;
-  std::string Error() noexcept override;
-
   // Ban RAII operations
   BaseContext(const BaseContext&) = delete;
   BaseContext(BaseContext&& other) = delete;
   BaseContext& operator=(BaseContext&& other) = delete;
   BaseContext& operator=(const BaseContext&) = delete;
 
+ protected:
+  /// @brief Create BaseContext
+  /// @param ops [in] operations of the concrete type
+  explicit BaseContext(const ContextOps* ops) noexcept
+      : AContext(ops), instance_ptr_(nullptr){};
+
+  ~BaseContext() noexcept = default;
+
  protected:
   T* instance_ptr_;
-  bool is_valid_;      // has error or not
-  std::string error_;  // error description
 };
 
 // Implementation
@@ -83,16 +79,6 @@ T* BaseContext<T>::GetInstance() noexcept {
   return instance_ptr_;
 }
 
-template <typename T>
-inline bool BaseContext<T>::IsValid() noexcept {
-  return is_valid_;
-}
-
-template <typename T>
-inline std::string BaseContext<T>::Error() noexcept {
-  return error_;
-}
-
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
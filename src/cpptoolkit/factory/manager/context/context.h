@@ -30,8 +30,6 @@
 #ifndef CPP_TOOL_KIT_FACTORY_CONTEXT_H_
 #define CPP_TOOL_KIT_FACTORY_CONTEXT_H_
 
-#include <vector>
-
 #include "base_context.h"
 #include "dependency_container.h"
 #include "ptr_holder.h"
@@ -42,50 +40,66 @@ namespace engine {
 
 class Core;
 
-/// @brief Contains pointer to managed object
+/// @brief Contains pointer to managed object. The instance can be created in
+/// the storage of the context (the memory block after the context or the
+/// arena of the dependency tree), in this case it is destroyed but not
+/// deleted
 /// @tparam T type of managed object
 template <typename T>
 class Context : public BaseContext<T>, public DependencyContainer {
   using BaseContext<T>::instance_ptr_;
-  using BaseContext<T>::is_valid_;
-  using BaseContext<T>::error_;
 
  public:
   /// @brief Create context
-  Context() noexcept : BaseContext<T>(true){};
+  /// @param arena [in] arena of the tree which owns the context or nullptr,
+  /// the dependencies and the instance are placed in it
+  explicit Context(Arena* arena = nullptr) noexcept
+      : BaseContext<T>(&ContextTable<Context>::kOps),
+        DependencyContainer(arena){};
 
   ~Context() noexcept;
 
-  void Add(PtrHolder<AContext>&& dependency) noexcept override;
+  /// @brief Add context of dependent object, the error of invalid dependency
+  /// becomes the error of the context
+  /// @param dependency [in] context of dependent object
+  void Add(PtrHolder<AContext>&& dependency) noexcept;
+
+  static const ContextKind kKind = ContextKind::kOwning;
+
+  /// @brief Delete the context
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    delete static_cast<Context*>(context);
+  };
 
   // Ban RAII operations
   Context(const Context&) = delete;
   Context(Context&& other) = delete;
   Context& operator=(Context&& other) = delete;
   Context& operator=(const Context&) = delete;
-
- private:
-  std::vector<PtrHolder<AContext>> dependencies_;
 };
 
 // implementation
 
 template <typename T>
 Context<T>::~Context() noexcept {
-  if (instance_ptr_ != nullptr) {
+  if (instance_ptr_ != nullptr && !IsInStorage(instance_ptr_)) {
     delete instance_ptr_;
   }
+
+  DestroyStorage();
 }
 
 template <typename T>
 inline void Context<T>::Add(PtrHolder<AContext>&& dependency) noexcept {
-  bool dependency_valid = dependency->IsValid();
-  if (!dependency_valid) {
-    is_valid_ = dependency_valid;
-    error_ = dependency->Error();
+  if (!dependency->IsValid()) {
+    this->error_ = dependency->GetErrorInfo();  // the dependency owns the error
   }
 
-  dependencies_.push_back(std::move(dependency));
+  if (!Push(std::move(dependency))) {
+    // the dependency is released, its instance can not be used
+    this->error_ = ErrorInfo::NoMemory();
+  }
 }
 
 }  // namespace engine
@@ -30,8 +30,11 @@
 #ifndef CPP_TOOL_KIT_FACTORY_DEPENDENCY_CONTAINER_H_
 #define CPP_TOOL_KIT_FACTORY_DEPENDENCY_CONTAINER_H_
 
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
+#include "../../tool/arena.h"
 #include "abstract_context.h"
 #include "ptr_holder.h"
 
@@ -39,16 +42,245 @@ namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
-/// @brief Contains base information about dependency
+/// Contains dependencies and the storage of the context. The container has
+/// no virtual methods, the dependencies are kept out of the context only if
+/// they are present: at the end of the storage, in the arena of the
+/// dependency tree or in the heap. The arena is given on construction and
+/// used until the tree is created, the arena of the current thread is never
+/// used: a dependency can be added later (lazy dependency) while another tree
+/// is created.
 class DependencyContainer {
  public:
-  virtual ~DependencyContainer() noexcept = default;
+  /// @brief Create empty container
+  /// @param arena [in] arena of the tree which owns the container or nullptr
+  explicit DependencyContainer(Arena* arena = nullptr) noexcept
+      : dependencies_(nullptr),
+        dependency_size_(0),
+        dependency_capacity_(0),
+        owns_dependencies_(0),
+        is_constructed_(0),
+        storage_(nullptr),
+        storage_size_(0),
+        requested_storage_(0),
+        arena_(arena){};
 
-  /// @brief Add context of dependent object pointer
+  /// @brief Destroy dependencies, the instance is destroyed before
+  ~DependencyContainer() noexcept;
+
+  /// @brief Add context of dependent object pointer, in fail case (no
+  /// memory) the dependency is not moved
   /// @param dependency context of dependent object
-  virtual void Add(PtrHolder<AContext>&& dependency) noexcept = 0;
+  /// @return Operation result
+  bool Push(PtrHolder<AContext>&& dependency) noexcept;
+
+  /// @brief Get memory in the context for the instance of managed object
+  /// @param size [in] size of the instance
+  /// @param align [in] alignment of the instance
+  /// @return Pointer to memory or nullptr if the context has no memory for it
+  void* Storage(size_t size, size_t align) noexcept;
+
+  /// @brief Set function which destroys the instance created in the storage
+  /// @param destroy [in] function, calls destructor of the instance
+  void SetStorageDestroy(void (*destroy)(void*)) noexcept;
+
+  /// @brief Set memory for the instance of managed object and dependencies
+  /// @param storage [in] pointer to memory, aligned as std::max_align_t
+  /// @param size [in] size of memory
+  void SetStorage(void* storage, size_t size) noexcept;
+
+  /// @brief Size of the storage which is required to keep the instance and
+  /// the dependencies in the context
+  /// @return Size or 0 if they are already in the storage or in the arena
+  size_t RequiredStorage() const noexcept;
+
+  /// @brief Allocate memory for dependencies, it is taken from the end of the
+  /// storage if it is enough
+  /// @param count [in] expected number of dependencies
+  void ReserveDependencies(size_t count) noexcept;
+
+  /// @brief Number of dependencies
+  /// @return Number of dependencies
+  size_t DependencyCount() const noexcept { return dependency_size_; };
+
+  /// @brief Stop using the arena, the tree is created. Dependencies which
+  /// are added later are placed in the heap
+  void DetachArena() noexcept;
+
+  // Ban RAII operations
+  DependencyContainer(const DependencyContainer&) = delete;
+  DependencyContainer(DependencyContainer&& other) = delete;
+  DependencyContainer& operator=(DependencyContainer&& other) = delete;
+  DependencyContainer& operator=(const DependencyContainer&) = delete;
+
+ protected:
+  bool IsInStorage(const void* ptr) const noexcept;
+
+  /// @brief Destroy the instance if it is created in the storage
+  void DestroyStorage() noexcept;
+
+ private:
+  bool ReallocateDependencies(size_t capacity) noexcept;
+
+ private:
+  PtrHolder<AContext>* dependencies_;
+  uint32_t dependency_size_;
+  uint32_t dependency_capacity_ : 30;
+  uint32_t owns_dependencies_ : 1;  // the dependencies are in the heap
+  uint32_t is_constructed_ : 1;     // the instance is in the storage
+
+ protected:
+  char* storage_;
+  uint32_t storage_size_;
+  uint32_t requested_storage_;
+
+ private:
+  // the arena is not used after the instance is created in the storage
+  union {
+    Arena* arena_;            // arena of the tree or nullptr
+    void (*destroy_)(void*);  // destroys the instance in the storage
+  };
 };
 
+// Implementation
+
+inline DependencyContainer::~DependencyContainer() noexcept {
+  for (uint32_t i = 0; i < dependency_size_; ++i) {
+    dependencies_[i].~PtrHolder();
+  }
+
+  if (owns_dependencies_) {
+    ::operator delete(dependencies_);
+  }
+}
+
+inline bool DependencyContainer::Push(
+    PtrHolder<AContext>&& dependency) noexcept {
+  if (dependency_size_ == dependency_capacity_ &&
+      !ReallocateDependencies(dependency_capacity_ == 0
+                                  ? 1
+                                  : dependency_capacity_ * 2)) {
+    return false;
+  }
+
+  new (dependencies_ + dependency_size_)
+      PtrHolder<AContext>(std::move(dependency));
+  ++dependency_size_;
+  return true;
+}
+
+inline void* DependencyContainer::Storage(size_t size, size_t align) noexcept {
+  if (is_constructed_ || align > alignof(std::max_align_t)) {
+    return nullptr;  // the storage is used or the instance can not be placed
+  }
+
+  if (size > storage_size_) {
+    // the context is created in the arena of its tree
+    void* memory = arena_ != nullptr ? arena_->Allocate(size, align) : nullptr;
+    if (memory != nullptr) {
+      SetStorage(memory, size);
+      return storage_;
+    }
+
+    if (size > requested_storage_) {
+      requested_storage_ = static_cast<uint32_t>(size);
+    }
+
+    return nullptr;
+  }
+
+  return storage_;
+}
+
+inline void DependencyContainer::SetStorageDestroy(
+    void (*destroy)(void*)) noexcept {
+  destroy_ = destroy;
+  is_constructed_ = 1;
+}
+
+inline void DependencyContainer::SetStorage(void* storage,
+                                            size_t size) noexcept {
+  storage_ = static_cast<char*>(storage);
+  storage_size_ = static_cast<uint32_t>(size);
+}
+
+inline size_t DependencyContainer::RequiredStorage() const noexcept {
+  if (requested_storage_ == 0 && !owns_dependencies_) {
+    return 0;
+  }
+
+  const size_t align = alignof(PtrHolder<AContext>);
+  return (requested_storage_ + align - 1) / align * align +
+         dependency_size_ * sizeof(PtrHolder<AContext>);
+}
+
+inline void DependencyContainer::ReserveDependencies(size_t count) noexcept {
+  if (count <= dependency_capacity_) {
+    return;
+  }
+
+  ReallocateDependencies(count);
+}
+
+inline void DependencyContainer::DetachArena() noexcept {
+  if (!is_constructed_) {
+    arena_ = nullptr;
+  }
+}
+
+inline void DependencyContainer::DestroyStorage() noexcept {
+  if (is_constructed_) {
+    destroy_(storage_);
+  }
+}
+
+inline bool DependencyContainer::IsInStorage(const void* ptr) const noexcept {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t storage = reinterpret_cast<uintptr_t>(storage_);
+  return address >= storage && address < storage + storage_size_;
+}
+
+inline bool DependencyContainer::ReallocateDependencies(
+    size_t capacity) noexcept {
+  const size_t size = capacity * sizeof(PtrHolder<AContext>);
+  const size_t align = alignof(PtrHolder<AContext>);
+  void* memory = nullptr;
+  bool owned = false;
+
+  if (!is_constructed_ && dependency_size_ == 0 && size <= storage_size_) {
+    // the end of the storage, the instance is created later at the beginning
+    const uintptr_t end =
+        reinterpret_cast<uintptr_t>(storage_) + storage_size_ - size;
+    memory = reinterpret_cast<void*>(end / align * align);
+    storage_size_ = static_cast<uint32_t>(
+        static_cast<char*>(memory) - storage_);
+  } else if (!is_constructed_ && arena_ != nullptr) {
+    memory = arena_->Allocate(size, align);
+  }
+
+  if (memory == nullptr) {
+    memory = ::operator new(size, std::nothrow);
+    owned = true;
+    if (memory == nullptr) {
+      return false;
+    }
+  }
+
+  PtrHolder<AContext>* dependencies = static_cast<PtrHolder<AContext>*>(memory);
+  for (uint32_t i = 0; i < dependency_size_; ++i) {
+    new (dependencies + i) PtrHolder<AContext>(std::move(dependencies_[i]));
+    dependencies_[i].~PtrHolder();
+  }
+
+  if (owns_dependencies_) {
+    ::operator delete(dependencies_);
+  }
+
+  dependencies_ = dependencies;
+  dependency_capacity_ = static_cast<uint32_t>(capacity);
+  owns_dependencies_ = owned ? 1 : 0;
+  return true;
+}
+
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
@@ -33,22 +33,42 @@
 #include <string>
 
 #include "base_context.h"
+#include "shared_context.h"
 
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
-/// @brief Contains error description
+/// @brief Contains error description, owns the error
 /// @tparam T type of managed object
 template <typename T>
 class ErrorContext : public BaseContext<T> {
-  using BaseContext<T>::error_;
-
  public:
   /// @brief Create error context
   /// @param error error description
-  ErrorContext(std::string error) noexcept : BaseContext<T>(false) {
-    error_ = error;
+  ErrorContext(std::string error) noexcept
+      : BaseContext<T>(&ContextTable<ErrorContext>::kOps),
+        info_(ErrorCode::kMessage, nullptr, error) {
+    this->error_ = &info_;
+  };
+
+  /// @brief Create error context
+  /// @param code [in] reason of the error
+  /// @param subject [in] type name or type key
+  /// @param detail [in] additional description
+  ErrorContext(ErrorCode code, const char* subject,
+               std::string detail = std::string()) noexcept
+      : BaseContext<T>(&ContextTable<ErrorContext>::kOps),
+        info_(code, subject, std::move(detail)) {
+    this->error_ = &info_;
+  };
+
+  static const ContextKind kKind = ContextKind::kError;
+
+  /// @brief Delete the context
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    delete static_cast<ErrorContext*>(context);
   };
 
   // Ban RAII operations
@@ -56,8 +76,21 @@ class ErrorContext : public BaseContext<T> {
   ErrorContext(ErrorContext&& other) = delete;
   ErrorContext& operator=(ErrorContext&& other) = delete;
   ErrorContext& operator=(const ErrorContext&) = delete;
+
+ private:
+  ErrorInfo info_;
 };
 
+/// @brief Get error context of failed allocation, it is static and is
+/// shared by all failed allocations of the type
+/// @tparam T type of managed object
+/// @return Pointer to the context, it is not deleted at the end of usage
+template <typename T>
+inline ErrorContext<T>* NoMemoryContext() noexcept {
+  static SharedContext<ErrorContext<T>> context(ErrorCode::kNoMemory, nullptr);
+  return &context;
+}
+
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
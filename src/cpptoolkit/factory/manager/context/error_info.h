@@ -0,0 +1,161 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_ERROR_INFO_H_
+#define CPP_TOOL_KIT_FACTORY_ERROR_INFO_H_
+
+#include <cstdint>
+#include <string>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Reason of the error on creation of managed object
+enum class ErrorCode : uint8_t {
+
+  /// @brief There is no error
+  kNone = 0,
+
+  /// @brief Error with custom message
+  kMessage = 1,
+
+  /// @brief Type (with the key) is not registered
+  kNotRegistered = 2,
+
+  /// @brief Object is requested over empty handle
+  kEmptyHandle = 3,
+
+  /// @brief Create function returned nullptr
+  kCreateReturnedNull = 4,
+
+  /// @brief Create function threw std::exception
+  kCreateException = 5,
+
+  /// @brief Create function threw unknown exception
+  kCreateUnknownException = 6,
+
+  /// @brief There is no memory for the context
+  kNoMemory = 7,
+
+  /// @brief Object depends on itself over its dependencies
+  kCyclicDependency = 8,
+
+  /// @brief Chain of dependencies in progress is too long
+  kTooDeep = 9,
+
+  /// @brief Wrapper has no context (empty result of 'TryGet()' or reset)
+  kNotInitialized = 10
+};
+
+/// Error description: the code, the subject (type name or type key) and
+/// optional detail, both are owned by the error, so the error does not depend
+/// on the Core. The text is built only on request, contexts keep pointer to
+/// the error of the failed dependency and do not copy it.
+class ErrorInfo {
+ public:
+  /// @brief Create error
+  /// @param code [in] reason of the error
+  /// @param subject [in] type name or type key, can be nullptr
+  /// @param detail [in] additional description
+  ErrorInfo(ErrorCode code, const char* subject,
+            std::string detail = std::string()) noexcept
+      : code_(code),
+        subject_(subject != nullptr ? subject : ""),
+        detail_(std::move(detail)){};
+
+  /// @brief Reason of the error
+  /// @return Error code
+  ErrorCode Code() const noexcept { return code_; };
+
+  /// @brief Build human readable description
+  /// @return Error message
+  std::string Message() const noexcept;
+
+  /// @brief Error of failed allocation (static)
+  /// @return Pointer to the error
+  static const ErrorInfo* NoMemory() noexcept;
+
+  // Ban RAII operations
+  ErrorInfo(const ErrorInfo&) = delete;
+  ErrorInfo(ErrorInfo&& other) = delete;
+  ErrorInfo& operator=(ErrorInfo&& other) = delete;
+  ErrorInfo& operator=(const ErrorInfo&) = delete;
+
+ private:
+  ErrorCode code_;
+  std::string subject_;
+  std::string detail_;
+};
+
+// Implementation
+
+inline std::string ErrorInfo::Message() const noexcept {
+  const std::string& subject = subject_;
+  switch (code_) {
+    case ErrorCode::kNone:
+      return std::string();
+    case ErrorCode::kMessage:
+      return detail_;
+    case ErrorCode::kNotRegistered:
+      return "Type: " + subject + detail_ + " is not registered";
+    case ErrorCode::kEmptyHandle:
+      return "Type: " + subject + " handle is empty, type is not registered";
+    case ErrorCode::kCreateReturnedNull:
+      return "Error on create instance: " + subject +
+             " 'Create' returned nullptr";
+    case ErrorCode::kCreateException:
+      return "Error on create instance: " + subject + " Error: " + detail_;
+    case ErrorCode::kCreateUnknownException:
+      return "Unknown error on create instance: " + subject;
+    case ErrorCode::kNoMemory:
+      return "Not enough memory for dependency";
+    case ErrorCode::kCyclicDependency:
+      return "Error on create instance: " + subject +
+             " depends on itself (cyclic dependency)";
+    case ErrorCode::kTooDeep:
+      return "Error on create instance: " + subject +
+             " the chain of dependencies is too deep";
+    case ErrorCode::kNotInitialized:
+      return "Instance is not initialized";
+  }
+
+  return detail_;
+}
+
+inline const ErrorInfo* ErrorInfo::NoMemory() noexcept {
+  static const ErrorInfo error(ErrorCode::kNoMemory, nullptr);
+  return &error;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_ERROR_INFO_H_
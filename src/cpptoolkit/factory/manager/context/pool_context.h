@@ -46,7 +46,10 @@ class AbstractPoolInstancePutback {
   virtual void Callback(uintptr_t key) noexcept = 0;
 };
 
-/// @brief Contains info about instance from the pool
+/// @brief Slot of the pool, owns the object with its dependencies. The slot
+/// is created once with the object and it is the context of every checkout,
+/// at the end of usage it is not deleted but put back to the pool, so taking
+/// and returning the object does not allocate memory
 /// @tparam T type of managed object
 template <typename T>
 class PoolContext : public BaseContext<T> {
@@ -55,15 +58,25 @@ class PoolContext : public BaseContext<T> {
  public:
   /// @brief Create context
   /// @param putback [in] pointer to observer
-  /// @param context [in] pointer to context (with object instance and validation
-  /// state)
-  PoolContext(AbstractPoolInstancePutback* putback, Context<T>* ctx,
-              uintptr_t key) noexcept
-      : BaseContext<T>(true), putback_(putback), key_(key) {
-    instance_ptr_ = ctx->GetInstance();
+  /// @param context [in] context with the object instance and dependencies
+  PoolContext(AbstractPoolInstancePutback* putback,
+              PtrHolder<Context<T>>&& context) noexcept
+      : BaseContext<T>(&ContextTable<PoolContext>::kOps),
+        putback_(putback), context_(std::move(context)) {
+    instance_ptr_ = context_->GetInstance();
   };
 
-  ~PoolContext() noexcept;
+  ~PoolContext() noexcept = default;
+
+  static const ContextKind kKind = ContextKind::kPool;
+
+  /// @brief Put the object back to the pool, the pool deletes the slot
+  /// if it is not needed
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    PoolContext* slot = static_cast<PoolContext*>(context);
+    slot->putback_->Callback(reinterpret_cast<uintptr_t>(slot));
+  };
 
   // Ban RAII operations
   PoolContext(const PoolContext&) = delete;
@@ -73,16 +86,9 @@ class PoolContext : public BaseContext<T> {
 
  private:
   AbstractPoolInstancePutback* putback_;
-  uintptr_t key_;
+  PtrHolder<Context<T>> context_;
 };
 
-// Implementation
-
-template <typename T>
-PoolContext<T>::~PoolContext() noexcept {
-  putback_->Callback(key_);
-}
-
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
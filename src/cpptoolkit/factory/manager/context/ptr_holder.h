@@ -31,11 +31,26 @@
 #define CPP_TOOL_KIT_FACTORY_PTR_HOLDER_H_
 
 #include <memory>
+#include <type_traits>
+
+#include "abstract_context.h"
 
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
+class AInstanceManager;
+
+/// @brief Check if the object decides how it is released (contexts and
+/// instance managers have method 'Release()')
+/// @tparam T type of managed object
+template <class T>
+struct IsReleasable
+    : std::integral_constant<bool,
+                             std::is_base_of<AContext, T>::value ||
+                                 std::is_base_of<AInstanceManager, T>::value> {
+};
+
 /// @brief Contains pointer to object in heap, provides only move operations
 /// @tparam T type of managed object
 template <class T>
@@ -96,6 +111,23 @@ class PtrHolder {
   T *instance_ptr_;
 };
 
+/// @brief Release context or instance manager, the object decides how it is
+/// released
+/// @tparam T type of context or instance manager
+/// @param instance [in] pointer to object
+template <class T>
+inline void DeleteInstance(T *instance, std::true_type) noexcept {
+  instance->Release();
+}
+
+/// @brief Delete managed object
+/// @tparam T type of managed object
+/// @param instance [in] pointer to managed object
+template <class T>
+inline void DeleteInstance(T *instance, std::false_type) noexcept {
+  delete instance;
+}
+
 /// @brief Create PtrHolder (RAII wrapper)
 /// @tparam T - The type of object to create
 /// @tparam ...Args - types of arguments for T
@@ -136,7 +168,7 @@ T *PtrHolder<T>::Relese() noexcept {
 template <class T>
 void PtrHolder<T>::Reset() noexcept {
   if (instance_ptr_ != nullptr) {
-    delete instance_ptr_;
+    DeleteInstance(instance_ptr_, IsReleasable<T>());
     instance_ptr_ = nullptr;
   }
 }
@@ -0,0 +1,121 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_REF_CONTEXT_H_
+#define CPP_TOOL_KIT_FACTORY_REF_CONTEXT_H_
+
+#include <atomic>
+
+#include "../../tool/memory_resource.h"
+#include "../../tool/resolution_scope.h"
+#include "base_context.h"
+#include "ptr_holder.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Shares the context of the instance by several consumers of one
+/// resolution, every consumer holds a reference and the last one deletes
+/// the context, so the instance is deleted exactly once. The context is
+/// created by 'NewInResource()'
+/// @tparam T type of managed object
+template <typename T>
+class RefContext : public BaseContext<T> {
+ public:
+  /// @brief Create instance with one reference
+  /// @param resource [in] owner of the memory of the context
+  /// @param context [in] valid context with the instance
+  /// @param owner [in] instance manager which created the context
+  /// @param arena [in] arena of the tree or nullptr
+  RefContext(MemoryResource* resource, PtrHolder<BaseContext<T>>&& context,
+             const void* owner, Arena* arena) noexcept;
+
+  ~RefContext() noexcept {};
+
+  static const ContextKind kKind = ContextKind::kRef;
+
+  /// @brief Release one reference, the last one deletes the context
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept;
+
+  /// @brief Add reference
+  /// @return Pointer to the context
+  RefContext<T>* AddRef() noexcept;
+
+  /// @brief Entry of the context for the resolution scope
+  /// @return Pointer to the entry
+  ScopeEntry* Entry() noexcept { return &entry_; };
+
+  // Ban RAII operations
+  RefContext(const RefContext&) = delete;
+  RefContext(RefContext&& other) = delete;
+  RefContext& operator=(RefContext&& other) = delete;
+  RefContext& operator=(const RefContext&) = delete;
+
+ private:
+  MemoryResource* resource_;
+  PtrHolder<BaseContext<T>> context_;
+  std::atomic<uint32_t> count_;
+  ScopeEntry entry_;
+};
+
+// Implementation
+
+template <typename T>
+RefContext<T>::RefContext(MemoryResource* resource,
+                          PtrHolder<BaseContext<T>>&& context,
+                          const void* owner, Arena* arena) noexcept
+    : BaseContext<T>(&ContextTable<RefContext>::kOps),
+      resource_(resource),
+      context_(std::move(context)),
+      count_(1),
+      entry_{owner, arena, this, nullptr} {
+  BaseContext<T>::SetInstance(context_->GetInstance());
+}
+
+template <typename T>
+void RefContext<T>::Free(AContext* context) noexcept {
+  RefContext<T>* self = static_cast<RefContext<T>*>(context);
+  if (self->count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    DeleteInResource(self->resource_, self);
+  }
+}
+
+template <typename T>
+RefContext<T>* RefContext<T>::AddRef() noexcept {
+  count_.fetch_add(1, std::memory_order_relaxed);
+  return this;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_REF_CONTEXT_H_
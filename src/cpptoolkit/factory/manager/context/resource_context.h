@@ -0,0 +1,85 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_RESOURCE_CONTEXT_H_
+#define CPP_TOOL_KIT_FACTORY_RESOURCE_CONTEXT_H_
+
+#include <utility>
+
+#include "../../tool/memory_resource.h"
+#include "ptr_holder.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Context created in the memory of the resource, the memory is
+/// returned to the resource at the end of usage
+/// @tparam C type of context
+template <typename C>
+class ResourceContext : public C {
+ public:
+  /// @brief Create context
+  /// @param resource [in] owner of the memory
+  /// @param ...args [in] arguments for C constructor
+  template <typename... Args>
+  ResourceContext(MemoryResource* resource, Args&&... args) noexcept
+      : C(std::forward<Args>(args)...), resource_(resource) {
+    this->ops_ = &ContextTable<ResourceContext>::kOps;
+  };
+
+  /// @brief Destroy the context and return the memory to the resource
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    ResourceContext* self = static_cast<ResourceContext*>(context);
+    DeleteInResource(self->resource_, self);
+  };
+
+ private:
+  MemoryResource* resource_;
+};
+
+/// @brief Create context in the memory of the resource
+/// @tparam C type of context
+/// @tparam ...Args types of arguments for C
+/// @param resource [in] source of memory
+/// @param ...args [in] arguments for C constructor
+/// @return PtrHolder with context, it is empty if there is no memory
+template <typename C, typename... Args>
+inline PtrHolder<C> MakeResourceContext(MemoryResource* resource,
+                                        Args&&... args) noexcept {
+  return PtrHolder<C>(NewInResource<ResourceContext<C>>(
+      resource, resource, std::forward<Args>(args)...));
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_RESOURCE_CONTEXT_H_
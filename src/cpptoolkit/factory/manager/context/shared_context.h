@@ -0,0 +1,109 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_SHARED_CONTEXT_H_
+#define CPP_TOOL_KIT_FACTORY_SHARED_CONTEXT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "../../tool/memory_resource.h"
+#include "abstract_context.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Context which is owned by a manager or is static and is shared by
+/// many requests, it is not deleted at the end of usage
+/// @tparam C type of context (ErrorContext<T>, WeakContext<T>)
+template <typename C>
+class SharedContext : public C {
+ public:
+  /// @brief Create context
+  /// @param ...args [in] arguments for C constructor
+  template <typename... Args>
+  SharedContext(Args&&... args) noexcept : C(std::forward<Args>(args)...) {
+    this->ops_ = &ContextTable<SharedContext>::kOps;
+  };
+
+  /// @brief The context is not deleted
+  static void Free(AContext* /*context*/) noexcept {};
+
+  /// @brief Delete the context by the owner
+  /// @param context [in] context of this type
+  static void Delete(AContext* context) noexcept {
+    delete static_cast<SharedContext*>(context);
+  };
+};
+
+/// @brief Immutable context which is shared by its owner (a manager or the
+/// core) and by many requests. Every user holds a reference and the last one
+/// deletes the context, so the context can outlive its owner. The context is
+/// created by 'NewInResource()'
+/// @tparam C type of context (ErrorContext<T>)
+template <typename C>
+class CountedContext : public C {
+ public:
+  /// @brief Create context with one reference (for the owner)
+  /// @param resource [in] owner of the memory of the context
+  /// @param ...args [in] arguments for C constructor
+  template <typename... Args>
+  CountedContext(MemoryResource* resource, Args&&... args) noexcept
+      : C(std::forward<Args>(args)...), resource_(resource), count_(1) {
+    this->ops_ = &ContextTable<CountedContext>::kOps;
+  };
+
+  /// @brief Release one reference, the last one deletes the context
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    CountedContext* self = static_cast<CountedContext*>(context);
+    if (self->count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      DeleteInResource(self->resource_, self);
+    }
+  };
+
+  /// @brief Add reference
+  /// @return Pointer to the context
+  CountedContext* AddRef() noexcept {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    return this;
+  };
+
+ private:
+  MemoryResource* resource_;
+  std::atomic<uint32_t> count_;
+};
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_SHARED_CONTEXT_H_
@@ -0,0 +1,95 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_SLAB_CONTEXT_H_
+#define CPP_TOOL_KIT_FACTORY_SLAB_CONTEXT_H_
+
+#include <new>
+
+#include "../../tool/slab.h"
+#include "ptr_holder.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Context created in the memory block of the slab, the block is
+/// returned to the slab at the end of usage
+/// @tparam C type of context
+template <typename C>
+class SlabContext : public C {
+ public:
+  /// @brief Create context
+  /// @param slab [in] owner of the memory block
+  /// @param ...args [in] arguments for C constructor
+  template <typename... Args>
+  SlabContext(Slab* slab, Args&&... args) noexcept
+      : C(std::forward<Args>(args)...), slab_(slab) {
+    this->ops_ = &ContextTable<SlabContext>::kOps;
+  };
+
+  /// @brief Destroy the context and return the block to the slab
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    SlabContext* self = static_cast<SlabContext*>(context);
+    Slab* slab = self->slab_;
+    self->~SlabContext();
+    slab->Free(self);
+  };
+
+ private:
+  Slab* slab_;
+};
+
+/// @brief Create context in the slab or in the heap if there is no slab
+/// @tparam C type of context
+/// @tparam ...Args types of arguments for C
+/// @param slab [in] slab for contexts of type C or nullptr
+/// @param ...args [in] arguments for C constructor
+/// @return PtrHolder with context
+template <typename C, typename... Args>
+inline PtrHolder<C> MakeSlabContext(Slab* slab, Args&&... args) noexcept {
+  if (slab == nullptr) {
+    return MakePtrHolder<C>(std::forward<Args>(args)...);
+  }
+
+  void* block = slab->Allocate();
+  if (block == nullptr) {
+    return PtrHolder<C>(nullptr);
+  }
+
+  return PtrHolder<C>(
+      new (block) SlabContext<C>(slab, std::forward<Args>(args)...));
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_SLAB_CONTEXT_H_
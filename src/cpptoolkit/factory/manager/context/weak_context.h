@@ -50,6 +50,14 @@ class WeakContext : public BaseContext<T> {
 
   ~WeakContext() noexcept {};
 
+  static const ContextKind kKind = ContextKind::kWeak;
+
+  /// @brief Delete the context
+  /// @param context [in] context of this type
+  static void Free(AContext* context) noexcept {
+    delete static_cast<WeakContext*>(context);
+  };
+
   // Ban RAII operations
   WeakContext(const WeakContext&) = delete;
   WeakContext(WeakContext&& other) = delete;
@@ -60,7 +68,8 @@ class WeakContext : public BaseContext<T> {
 // Implementation
 
 template <typename T>
-WeakContext<T>::WeakContext(T* instance_ptr) noexcept : BaseContext<T>(true) {
+WeakContext<T>::WeakContext(T* instance_ptr) noexcept
+    : BaseContext<T>(&ContextTable<WeakContext>::kOps) {
   instance_ptr_ = instance_ptr;
 }
 
@@ -31,9 +31,10 @@
 #define CPP_TOOL_KIT_FACTORY_LOCK_POOL_INSTANCE_MANAGER_H_
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <unordered_map>
+#include <new>
+#include <vector>
 
 #include "base_instance_manager.h"
 #include "context/pool_context.h"
@@ -44,60 +45,111 @@ namespace engine {
 
 /// Locks the thread until an instance was put back to the pool (if it is empty)
 /// @tparam T type of managed object
-template <typename T>
+/// @tparam F type of creator, callable as 'T*(Resolver&)'
+template <typename T, typename F = CreateFunction<T>>
 class LockPoolInstanceManager : public BaseInstanceManager<T>,
                                 public AbstractPoolInstancePutback {
  public:
   /// @brief Create instance manager
-  /// @param class_name_key [in] unique key for current manager
-  /// @param create [in] function for create instance of managed object
+  /// @param key [in] unique key for a given object type
+  /// @param create [in] creator of instance of managed object
   /// @param core [in] pointer to the core_ with registered objects
   /// @param pool_size [in] size of pool object
+  /// @param resource [in] source of memory for contexts
   LockPoolInstanceManager(
-      std::string class_name_key,
-      std::function<T*(cpptoolkit::factory::Resolver&)>&& create,
-      cpptoolkit::factory::Core* core, uint32_t pool_size) noexcept
-      : BaseInstanceManager<T>(class_name_key, std::move(create), core),
+      std::string key, F create,
+      cpptoolkit::factory::Core* core, uint32_t pool_size,
+      MemoryResource* resource = NewDeleteResource()) noexcept
+      : BaseInstanceManager<T>(key, core, resource),
+        create_(std::move(create)),
         countdown_(pool_size),
-        waiter_counter_(0){};
+        waiter_counter_(0),
+        queue_(ResourceAllocator<PoolContext<T>*>(resource)),
+        index_(ResourceAllocator<PoolContext<T>*>(resource)) {
+    // the allocator of the resource throws if there is no memory, then the
+    // pool is empty and 'Get()' reports it
+    try {
+      queue_.reserve(pool_size);
+      index_.reserve(pool_size);
+    } catch (const std::bad_alloc&) {
+      countdown_ = 0;
+    }
+  };
 
-  virtual ~LockPoolInstanceManager() noexcept = default;
+  virtual ~LockPoolInstanceManager() noexcept {
+    for (PoolContext<T>* pool_context : index_) {
+      DeleteInResource(BaseInstanceManager<T>::resource_, pool_context);
+    }
+  };
 
   PtrHolder<BaseContext<T>> Get() noexcept override;
+
+  void Compile() noexcept override {
+    CompileCreator(create_, BaseInstanceManager<T>::core_);
+  };
+
+  size_t DeclaredDependencyCount() noexcept override {
+    return CreatorDependencyCount(create_);
+  };
+
+  AInstanceManager* DeclaredDependency(size_t index) noexcept override {
+    return CreatorDependency(create_, index);
+  };
+
+  bool DeclaresDependencies() noexcept override {
+    return CreatorDeclaresDependencies(create_);
+  };
   void Callback(uintptr_t key) noexcept override;
 
  private:
+  F create_;
   uint32_t countdown_;  // counter of objects what will be created for the pool
   uint32_t waiter_counter_;  // size of waiting threads
 
-  std::queue<uintptr_t> queue_;  // free objects in the pool
+  // free objects in the pool
+  std::vector<PoolContext<T>*, ResourceAllocator<PoolContext<T>*>> queue_;
 
-  // all created objects in the pool
-  std::unordered_map<uintptr_t, PtrHolder<Context<T>>> index_;
+  // all created objects in the pool, owns them
+  std::vector<PoolContext<T>*, ResourceAllocator<PoolContext<T>*>> index_;
 
   std::condition_variable queue_cv_;
   std::mutex mutex_;
 };
 
-template <typename T>
-inline PtrHolder<BaseContext<T>> LockPoolInstanceManager<T>::Get() noexcept {
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> LockPoolInstanceManager<T, F>::Get() noexcept {
+  // the object depends on itself, its creation already holds the mutex
+  if (BaseInstanceManager<T>::IsInProgress()) {
+    return this->ShareError(this->cycle_error_);
+  }
+
   std::unique_lock<std::mutex> locker(mutex_);
 
+  if (countdown_ == 0 && index_.empty()) {  // no memory for the pool
+    return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+  }
+
   if (countdown_ > 0 && queue_.empty()) {
     // create object for the pool
-    PtrHolder<Context<T>> context = MakePtrHolder<Context<T>>();
-    BaseInstanceManager<T>::Create(context.Get());
+    PtrHolder<Context<T>> context = BaseInstanceManager<T>::MakeContext();
+    if (context.Get() == nullptr) {  // no memory for the context
+      return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+    }
+    BaseInstanceManager<T>::Create(context.Get(), create_);
 
     if (!context->IsValid()) {
       return context;
     }
 
-    uintptr_t context_key = reinterpret_cast<uintptr_t>(context.Get());
-    PtrHolder<PoolContext<T>> pool_ctx =
-        MakePtrHolder<PoolContext<T>>(this, context.Get(), context_key);
-    index_.emplace(context_key, std::move(context));
+    PoolContext<T>* pool_context = NewInResource<PoolContext<T>>(
+        BaseInstanceManager<T>::resource_, this, std::move(context));
+    if (pool_context == nullptr) {
+      return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+    }
+
+    index_.push_back(pool_context);  // the memory is reserved
     --countdown_;
-    return pool_ctx;
+    return PtrHolder<BaseContext<T>>(pool_context);
   }
 
   if (queue_.empty()) {
@@ -107,19 +159,15 @@ inline PtrHolder<BaseContext<T>> LockPoolInstanceManager<T>::Get() noexcept {
     --waiter_counter_;
   }
 
-  uintptr_t key = queue_.front();
-  queue_.pop();
-  const auto it = index_.find(key);
-  PtrHolder<Context<T>>& context = it->second;
-  PtrHolder<PoolContext<T>> pool_context =
-      MakePtrHolder<PoolContext<T>>(this, context.Get(), key);
-  return pool_context;
+  PoolContext<T>* pool_context = queue_.back();
+  queue_.pop_back();
+  return PtrHolder<BaseContext<T>>(pool_context);
 }
 
-template <typename T>
-inline void LockPoolInstanceManager<T>::Callback(uintptr_t key) noexcept {
+template <typename T, typename F>
+inline void LockPoolInstanceManager<T, F>::Callback(uintptr_t key) noexcept {
   std::unique_lock<std::mutex> locker(mutex_);
-  queue_.push(key);
+  queue_.push_back(reinterpret_cast<PoolContext<T>*>(key));
   if (waiter_counter_ > 0) {
     queue_cv_.notify_one();
   }
@@ -30,38 +30,240 @@
 #ifndef CPP_TOOL_KIT_FACTORY_MULTIPLE_INSTANCE_MANAGER_H_
 #define CPP_TOOL_KIT_FACTORY_MULTIPLE_INSTANCE_MANAGER_H_
 
+#include <new>
+#include <vector>
+
 #include "base_instance_manager.h"
+#include "context/arena_context.h"
+#include "context/error_context.h"
+#include "context/ref_context.h"
 
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
-/// @brief Instance manager for multiple objects
+/// @brief Instance manager for multiple objects. The object and its multiple
+/// dependencies can be created in one arena, which is deleted with the object.
+/// The object can be shared by all consumers in the tree of one resolution.
+/// The tree of declared dependencies is created by the resolution plan
 /// @tparam T type of managed object
-template <typename T>
+/// @tparam F type of creator, callable as 'T*(Resolver&)'
+template <typename T, typename F = CreateFunction<T>>
 class MultipleInstanceManager : public BaseInstanceManager<T> {
  public:
   /// @brief Create MultipleInstanceManager
-  /// @param class_name_key [in] unique key for current manager
-  /// @param create [in] function for create instance of managed object
+  /// @param key [in] unique key for a given object type
+  /// @param create [in] creator of instance of managed object
   /// @param core [in] pointer to the core_ with registered objects
+  /// @param resource [in] source of memory for contexts
   MultipleInstanceManager(
-      std::string class_name_key,
-      std::function<T*(cpptoolkit::factory::Resolver&)>&& create,
-      cpptoolkit::factory::Core* core) noexcept
-      : BaseInstanceManager<T>(class_name_key, std::move(create), core){};
+      std::string key, F create,
+      cpptoolkit::factory::Core* core,
+      MemoryResource* resource = NewDeleteResource()) noexcept
+      : BaseInstanceManager<T>(key, core, resource),
+        create_(std::move(create)),
+        use_arena_(false),
+        share_(false),
+        arena_size_(Arena::kDefaultSize),
+        plan_(ResourceAllocator<PlanStep>(resource)){};
 
   virtual ~MultipleInstanceManager() noexcept {};
 
   PtrHolder<BaseContext<T>> Get() noexcept override;
+
+  void Compile() noexcept override {
+    CompileCreator(create_, BaseInstanceManager<T>::core_);
+  };
+
+  size_t DeclaredDependencyCount() noexcept override {
+    return CreatorDependencyCount(create_);
+  };
+
+  AInstanceManager* DeclaredDependency(size_t index) noexcept override {
+    return CreatorDependency(create_, index);
+  };
+
+  bool DeclaresDependencies() noexcept override {
+    return CreatorDeclaresDependencies(create_);
+  };
+
+  /// @brief Create the object with its dependency tree in one arena
+  /// @param use_arena [in] true to use the arena
+  void SetUseArena(bool use_arena) noexcept { use_arena_ = use_arena; };
+
+  /// @brief Create the object once in the tree of one resolution
+  /// @param share [in] true to share the object
+  void SetShareInResolution(bool share) noexcept { share_ = share; };
+
+  bool SharesInResolution() noexcept override { return share_; };
+
+  bool IsPlannable() noexcept override {
+    return !use_arena_ && !share_ && CreatorCreatesFromContexts(create_);
+  };
+
+  void SetPlan(const PlanStep* steps, size_t count) noexcept override;
+
+  PtrHolder<AContext> CreateFromPlan(
+      AContext** dependencies) noexcept override;
+
+ private:
+  /// @brief Create context with new instance
+  /// @return Context with instance of managed object
+  PtrHolder<BaseContext<T>> MakeInstance() noexcept;
+
+  /// @brief Get the context created in the current resolution scope or
+  /// create it and add to the scope
+  /// @param scope [in] resolution scope of the current thread
+  /// @return Shared context with instance of managed object
+  PtrHolder<BaseContext<T>> GetShared(ResolutionScope* scope) noexcept;
+
+  /// @brief Create context in the arena
+  /// @param arena [in] arena of the tree or nullptr for the root of the tree
+  /// @return Context with instance of managed object
+  PtrHolder<BaseContext<T>> GetInArena(Arena* arena) noexcept;
+
+ private:
+  F create_;
+  bool use_arena_;
+  bool share_;
+
+  // max used size of arena of the tree, the size of the next arena
+  std::atomic<size_t> arena_size_;
+
+  // resolution plan of the tree, empty if the object is created by 'Get()'
+  // of the dependencies
+  std::vector<PlanStep, ResourceAllocator<PlanStep>> plan_;
 };
 
 // Implementation
 
-template <typename T>
-inline PtrHolder<BaseContext<T>> MultipleInstanceManager<T>::Get() noexcept {
-  PtrHolder<Context<T>> context = MakePtrHolder<Context<T>>();
-  BaseInstanceManager<T>::Create(context.Get());
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> MultipleInstanceManager<T, F>::Get() noexcept {
+  if (share_) {
+    ResolutionScope* scope = ResolutionScope::Current();
+    if (scope != nullptr) {
+      return GetShared(scope);
+    }
+  }
+
+  return MakeInstance();
+}
+
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>>
+MultipleInstanceManager<T, F>::MakeInstance() noexcept {
+  // the object is a dependency in the tree which is created in the arena
+  Arena* arena = Arena::Current();
+  if (arena != nullptr || use_arena_) {
+    return GetInArena(arena);
+  }
+
+  if (!plan_.empty()) {
+    return RunPlan<T>(plan_.data(), plan_.size());
+  }
+
+  PtrHolder<Context<T>> context = BaseInstanceManager<T>::MakeContext();
+  if (context.Get() == nullptr) {  // no memory for the context
+    return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+  }
+  BaseInstanceManager<T>::Create(context.Get(), create_);
+  return context;
+}
+
+template <typename T, typename F>
+inline void MultipleInstanceManager<T, F>::SetPlan(const PlanStep* steps,
+                                                   size_t count) noexcept {
+  try {
+    plan_.assign(steps, steps + count);
+  } catch (const std::bad_alloc&) {
+    plan_.clear();  // the dependencies are created by their managers
+  }
+}
+
+template <typename T, typename F>
+inline PtrHolder<AContext> MultipleInstanceManager<T, F>::CreateFromPlan(
+    AContext** dependencies) noexcept {
+  PtrHolder<Context<T>> context = BaseInstanceManager<T>::MakeContext();
+  if (context.Get() == nullptr) {  // no memory for the context
+    ReleaseContexts(dependencies, DeclaredDependencyCount());
+    return PtrHolder<AContext>(NoMemoryContext<T>());
+  }
+
+  bool is_moved = false;
+  auto create = [this, dependencies, &is_moved](Resolver& resolver) {
+    is_moved = true;
+    return CreateFromContexts(create_, resolver, dependencies);
+  };
+  BaseInstanceManager<T>::Create(context.Get(), create);
+  if (!is_moved) {  // the creator was not called
+    ReleaseContexts(dependencies, DeclaredDependencyCount());
+  }
+
+  return PtrHolder<AContext>(std::move(context));
+}
+
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> MultipleInstanceManager<T, F>::GetShared(
+    ResolutionScope* scope) noexcept {
+  // a context of the tree in the arena is not shared with objects outside
+  // of the arena (single instances), it is deleted with the arena
+  Arena* arena = Arena::Current();
+  AContext* shared = scope->Find(this, arena);
+  if (shared != nullptr) {
+    return PtrHolder<BaseContext<T>>(
+        static_cast<RefContext<T>*>(shared)->AddRef());
+  }
+
+  PtrHolder<BaseContext<T>> context = MakeInstance();
+  if (!context->IsValid()) {
+    return context;
+  }
+
+  MemoryResource* resource = BaseInstanceManager<T>::resource_;
+  RefContext<T>* ref = NewInResource<RefContext<T>>(
+      resource, resource, std::move(context), this, arena);
+  if (ref == nullptr) {
+    return context;  // the instance is not shared
+  }
+
+  scope->Add(ref->AddRef()->Entry());  // the scope keeps one reference
+  return PtrHolder<BaseContext<T>>(ref);
+}
+
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> MultipleInstanceManager<T, F>::GetInArena(
+    Arena* arena) noexcept {
+  const bool is_root = arena == nullptr;
+  if (is_root) {
+    arena = Arena::Create(arena_size_.load(std::memory_order_relaxed),
+                          BaseInstanceManager<T>::resource_);
+  }
+
+  PtrHolder<Context<T>> context(nullptr);
+  if (arena != nullptr) {
+    context = MakeArenaContext<Context<T>>(arena, is_root, arena);
+  }
+
+  if (context.Get() == nullptr) {  // there is no memory in the arena
+    if (is_root) {
+      Arena::Destroy(arena);
+    }
+
+    context = BaseInstanceManager<T>::MakeContext();
+    if (context.Get() == nullptr) {  // no memory for the context
+      return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+    }
+    BaseInstanceManager<T>::Create(context.Get(), create_);
+    return context;
+  }
+
+  BaseInstanceManager<T>::Create(context.Get(), create_, arena);
+  context->DetachArena();  // the arena is not thread safe, the tree is ready
+
+  if (is_root && arena->Used() > arena_size_.load(std::memory_order_relaxed)) {
+    arena_size_.store(arena->Used(), std::memory_order_relaxed);
+  }
+
   return context;
 }
 
@@ -31,21 +31,62 @@
 #define CPP_TOOL_KIT_FACTORY_RESOLVER_H_
 
 #include <memory>
+#include <new>
 #include <string>
+#include <utility>
 
+#include "../tool/key.h"
 #include "context/base_context.h"
-#include "context/dependency_container.h"
+#include "context/context.h"
 
 namespace cpptoolkit {
 namespace factory {
 
 class Core;
 
+template <typename T>
+class Handle;
+
+template <typename T>
+class Lazy;
+
+template <typename T>
+class Factory;
+
+template <typename... Bindings>
+class StaticCore;
+
 namespace engine {
 
+template <typename T, typename... Deps>
+struct TypeCreator;
+
+template <typename T>
+PtrHolder<BaseContext<T>> GetContext(cpptoolkit::factory::Core* core) noexcept;
+
 template <typename T>
 PtrHolder<BaseContext<T>> GetContext(
-    cpptoolkit::factory::Core* core, const std::string& key) noexcept;
+    cpptoolkit::factory::Core* core, const Key& key) noexcept;
+
+template <typename T>
+PtrHolder<BaseContext<T>> GetContext(const Handle<T>& handle) noexcept;
+
+template <typename T>
+PtrHolder<BaseContext<T>> ResolveContext(
+    cpptoolkit::factory::Core* core) noexcept;
+
+template <typename T>
+PtrHolder<BaseContext<T>> ResolveContext(
+    cpptoolkit::factory::Core* core, const Key& key) noexcept;
+
+template <typename T>
+PtrHolder<BaseContext<T>> ResolveContext(const Handle<T>& handle) noexcept;
+
+template <typename T>
+Handle<T> GetHandle(cpptoolkit::factory::Core* core) noexcept;
+
+template <typename T>
+Handle<T> GetHandle(cpptoolkit::factory::Core* core, const Key& key) noexcept;
 
 }  // namespace engine
 
@@ -58,21 +99,114 @@ class Resolver {
  public:
   /// @brief Create instance of the helper
   /// @param core [in] pointer to the core_ with registered objects
-  /// @param d_container [in] collector for save dependencies
-  Resolver(Core* core, engine::DependencyContainer* d_container) noexcept
+  /// @param context [in] context of the created object, collects dependencies
+  template <typename T>
+  Resolver(Core* core, engine::Context<T>* context) noexcept
       : core_(core),
-        d_container_(d_container),
+        context_(context),
+        d_container_(context),
         is_valid_dependency_context_(true){};
 
+  /// @brief Get dependency, registered in the core_ with the default key.
+  /// @tparam T type of dependency object
+  /// @return Pointer to dependency object or 'nullptr' in error case
+  template <typename T>
+  T* Get() noexcept;
+
   /// @brief Get dependency, registered in the core_ with the key.
   /// @tparam T type of dependency object
   /// @param key [in] the key for access
   /// @return Pointer to dependency object or 'nullptr' in error case
   template <typename T>
-  T* Get(const std::string& key = engine::DEFAULT_KEY) noexcept;
+  T* Get(const Key& key) noexcept;
+
+  /// @brief Get dependency over pre-resolved handle, skips lookup in the core_
+  /// @tparam T type of dependency object
+  /// @param handle [in] handle of registered object
+  /// @return Pointer to dependency object or 'nullptr' in error case
+  template <typename T>
+  T* Get(const Handle<T>& handle) noexcept;
+
+  /// @brief Create instance in the memory of its context, so the instance
+  /// and the context need one allocation. Use it only for the returned
+  /// instance, if there is no memory it works as 'Create<T>(args...)'
+  /// @tparam T the type of object to create
+  /// @tparam ...Args types of arguments for T
+  /// @param ...args [in] arguments for T constructor
+  /// @return pointer to instance
+  template <typename T, typename... Args>
+  T* Construct(Args&&... args);
+
+  /// @brief Get dependency registered with the default key, which is created
+  /// on the first use. Keep it in the object
+  /// @tparam T type of dependency object
+  /// @return Lazy dependency, it is empty in error case
+  template <typename T>
+  Lazy<T> GetLazy() noexcept;
+
+  /// @brief Get dependency registered with the key, which is created on the
+  /// first use. Keep it in the object
+  /// @tparam T type of dependency object
+  /// @param key [in] the key for access
+  /// @return Lazy dependency, it is empty in error case
+  template <typename T>
+  Lazy<T> GetLazy(const Key& key) noexcept;
+
+  /// @brief Get dependency over pre-resolved handle, which is created on the
+  /// first use. Keep it in the object
+  /// @tparam T type of dependency object
+  /// @param handle [in] handle of registered object
+  /// @return Lazy dependency, it is empty in error case
+  template <typename T>
+  Lazy<T> GetLazy(const Handle<T>& handle) noexcept;
+
+  /// @brief Get factory of the object registered with the default key, keep
+  /// it in the object which creates many instances
+  /// @tparam T type of created object
+  /// @return Factory, it is empty in error case
+  template <typename T>
+  Factory<T> GetFactory() noexcept;
+
+  /// @brief Get factory of the object registered with the key, keep it in the
+  /// object which creates many instances
+  /// @tparam T type of created object
+  /// @param key [in] the key for access
+  /// @return Factory, it is empty in error case
+  template <typename T>
+  Factory<T> GetFactory(const Key& key) noexcept;
+
+ private:
+  template <typename... Bindings>
+  friend class StaticCore;
+
+  template <typename T, typename... Deps>
+  friend struct engine::TypeCreator;
+
+  /// @brief Get dependency with the default key without check of previous
+  /// dependencies, the caller checks 'is_valid_dependency_context_' once
+  /// after all dependencies are resolved
+  template <typename T>
+  T* Resolve() noexcept;
+
+  /// @brief Get dependency over pre-resolved handle without check of
+  /// previous dependencies
+  template <typename T>
+  T* Resolve(const Handle<T>& handle) noexcept;
+
+  /// @brief Reserve memory for known number of dependencies
+  void Reserve(size_t count) noexcept {
+    d_container_->ReserveDependencies(count);
+  };
+
+  template <typename T>
+  T* Add(engine::PtrHolder<engine::BaseContext<T>>&& dependency) noexcept;
+
+  template <typename T>
+  static void Destroy(void* instance) noexcept;
 
  private:
   Core* core_;
+  engine::AContext* context_;
   engine::DependencyContainer* d_container_;
   bool is_valid_dependency_context_;
 };
@@ -80,18 +214,150 @@ class Resolver {
 // implementation
 
 template <typename T>
-inline T* Resolver::Get(const std::string& key) noexcept {
+inline T* Resolver::Get() noexcept {
+  if (!is_valid_dependency_context_) {  // No sense to do something here,
+    return nullptr;  // a dependency context already has error
+  }
+
+  return Add<T>(engine::ResolveContext<T>(core_));
+}
+
+template <typename T>
+inline T* Resolver::Get(const Key& key) noexcept {
   if (!is_valid_dependency_context_) {  // No sense to do something here,
     return nullptr;  // a dependency context already has error
   }
 
-  engine::PtrHolder<engine::BaseContext<T>> dependency =
-      engine::GetContext<T>(core_, key);
+  return Add<T>(engine::ResolveContext<T>(core_, key));
+}
+
+template <typename T>
+inline T* Resolver::Get(const Handle<T>& handle) noexcept {
+  if (!is_valid_dependency_context_) {  // No sense to do something here,
+    return nullptr;  // a dependency context already has error
+  }
+
+  return Add<T>(engine::ResolveContext<T>(handle));
+}
+
+template <typename T>
+inline Lazy<T> Resolver::GetLazy() noexcept {
+  if (!is_valid_dependency_context_) {
+    return Lazy<T>();
+  }
+
+  Handle<T> handle = engine::GetHandle<T>(core_);
+  if (!handle.IsValid()) {
+    Add<T>(engine::GetContext<T>(core_));  // the error of not registered type
+    return Lazy<T>();
+  }
+
+  return Lazy<T>(handle.Manager(), d_container_);
+}
+
+template <typename T>
+inline Lazy<T> Resolver::GetLazy(const Key& key) noexcept {
+  if (!is_valid_dependency_context_) {
+    return Lazy<T>();
+  }
+
+  Handle<T> handle = engine::GetHandle<T>(core_, key);
+  if (!handle.IsValid()) {
+    Add<T>(engine::GetContext<T>(core_, key));
+    return Lazy<T>();
+  }
+
+  return Lazy<T>(handle.Manager(), d_container_);
+}
+
+template <typename T>
+inline Lazy<T> Resolver::GetLazy(const Handle<T>& handle) noexcept {
+  if (!is_valid_dependency_context_) {
+    return Lazy<T>();
+  }
+
+  if (!handle.IsValid()) {
+    Add<T>(engine::GetContext<T>(handle));
+    return Lazy<T>();
+  }
+
+  return Lazy<T>(handle.Manager(), d_container_);
+}
+
+template <typename T>
+inline Factory<T> Resolver::GetFactory() noexcept {
+  if (!is_valid_dependency_context_) {
+    return Factory<T>();
+  }
+
+  Handle<T> handle = engine::GetHandle<T>(core_);
+  if (!handle.IsValid()) {
+    Add<T>(engine::GetContext<T>(core_));  // the error of not registered type
+    return Factory<T>();
+  }
+
+  return Factory<T>(handle.Manager());
+}
+
+template <typename T>
+inline Factory<T> Resolver::GetFactory(const Key& key) noexcept {
+  if (!is_valid_dependency_context_) {
+    return Factory<T>();
+  }
+
+  Handle<T> handle = engine::GetHandle<T>(core_, key);
+  if (!handle.IsValid()) {
+    Add<T>(engine::GetContext<T>(core_, key));
+    return Factory<T>();
+  }
+
+  return Factory<T>(handle.Manager());
+}
+
+template <typename T>
+inline T* Resolver::Resolve() noexcept {
+  return Add<T>(engine::ResolveContext<T>(core_));
+}
+
+template <typename T>
+inline T* Resolver::Resolve(const Handle<T>& handle) noexcept {
+  return Add<T>(engine::ResolveContext<T>(handle));
+}
+
+template <typename T, typename... Args>
+inline T* Resolver::Construct(Args&&... args) {
+  void* storage = d_container_->Storage(sizeof(T), alignof(T));
+  if (storage == nullptr) {
+    return new T(std::forward<Args>(args)...);
+  }
+
+  T* instance = new (storage) T(std::forward<Args>(args)...);
+  d_container_->SetStorageDestroy(&Resolver::Destroy<T>);
+  return instance;
+}
+
+template <typename T>
+inline void Resolver::Destroy(void* instance) noexcept {
+  static_cast<T*>(instance)->~T();
+}
+
+template <typename T>
+inline T* Resolver::Add(
+    engine::PtrHolder<engine::BaseContext<T>>&& dependency) noexcept {
+  // set error if the context is not valid, the first error is kept
+  if (!dependency->IsValid()) {
+    if (is_valid_dependency_context_) {
+      context_->SetError(dependency->GetErrorInfo());  // the dependency owns it
+    }
+    is_valid_dependency_context_ = false;
+  }
 
-  // set error if the context is not valid
-  is_valid_dependency_context_ = dependency->IsValid();
   T* instance = dependency->GetInstance();
-  d_container_->Add(std::move(dependency));
+  if (!d_container_->Push(std::move(dependency))) {
+    // the dependency is released, its instance can not be used
+    is_valid_dependency_context_ = false;
+    context_->SetError(engine::ErrorInfo::NoMemory());
+  }
 
   if (!is_valid_dependency_context_) {
     return nullptr;
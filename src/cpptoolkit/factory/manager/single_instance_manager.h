@@ -30,68 +30,114 @@
 #ifndef CPP_TOOL_KIT_FACTORY_SINGLE_INSTANCE_MANAGER_H_
 #define CPP_TOOL_KIT_FACTORY_SINGLE_INSTANCE_MANAGER_H_
 
+#include <atomic>
 #include <mutex>
 
 #include "base_instance_manager.h"
 #include "context/error_context.h"
+#include "context/shared_context.h"
 #include "context/weak_context.h"
 
 namespace cpptoolkit {
 namespace factory {
 namespace engine {
 
-/// @brief Instance manager for single object
+/// @brief Instance manager for single object. After the object is created
+/// every 'Get()' returns a reference to the same counted context, so the
+/// call does not allocate memory. The context is deleted by the last
+/// reference, so a UPtr can outlive the Core
 /// @tparam T type of managed object
-template <typename T>
+/// @tparam F type of creator, callable as 'T*(Resolver&)'
+template <typename T, typename F = CreateFunction<T>>
 class SingleInstanceManager : public BaseInstanceManager<T> {
  public:
   /// @brief Create SingleInstanceManager
-  /// @param class_name_key [in] unique key for current manager
-  /// @param create [in] function for create instance of managed object
+  /// @param key [in] unique key for a given object type
+  /// @param create [in] creator of instance of managed object
   /// @param core [in] pointer to the core_ with registered objects
+  /// @param resource [in] source of memory for contexts
   SingleInstanceManager(
-      std::string class_name_key,
-      std::function<T*(cpptoolkit::factory::Resolver&)>&& create,
-      cpptoolkit::factory::Core* core) noexcept
-      : BaseInstanceManager<T>(class_name_key, std::move(create), core),
-        context_(nullptr){};
+      std::string key, F create,
+      cpptoolkit::factory::Core* core,
+      MemoryResource* resource = NewDeleteResource()) noexcept
+      : BaseInstanceManager<T>(key, core, resource),
+        create_(std::move(create)),
+        context_(nullptr),
+        weak_context_(nullptr),
+        is_created_(false){};
 
-  virtual ~SingleInstanceManager() noexcept {};
+  virtual ~SingleInstanceManager() noexcept {
+    if (weak_context_ != nullptr) {
+      WeakRef::Free(weak_context_);  // the reference of the manager
+    }
+  };
 
   PtrHolder<BaseContext<T>> Get() noexcept override;
 
+  void Compile() noexcept override {
+    CompileCreator(create_, BaseInstanceManager<T>::core_);
+  };
+
+  size_t DeclaredDependencyCount() noexcept override {
+    return CreatorDependencyCount(create_);
+  };
+
+  AInstanceManager* DeclaredDependency(size_t index) noexcept override {
+    return CreatorDependency(create_, index);
+  };
+
+  bool DeclaresDependencies() noexcept override {
+    return CreatorDeclaresDependencies(create_);
+  };
+
  private:
+  typedef CountedContext<WeakContext<T>> WeakRef;
+
+  F create_;
   PtrHolder<Context<T>> context_;
+  WeakRef* weak_context_;  // a reference is returned by every 'Get()'
+  std::atomic<bool> is_created_;
   std::mutex mutex_;
 };
 
 // Implementation
 
-template <typename T>
-inline PtrHolder<BaseContext<T>> SingleInstanceManager<T>::Get() noexcept {
-  if (context_.Get() != nullptr) {
-    PtrHolder<WeakContext<T>> weak_context =
-        MakePtrHolder<WeakContext<T>>(context_.Get()->GetInstance());
-    return weak_context;
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> SingleInstanceManager<T, F>::Get() noexcept {
+  if (is_created_.load(std::memory_order_acquire)) {
+    return PtrHolder<BaseContext<T>>(weak_context_->AddRef());
+  }
+
+  // the object depends on itself, its creation already holds the mutex
+  if (BaseInstanceManager<T>::IsInProgress()) {
+    return this->ShareError(this->cycle_error_);
   }
 
   std::unique_lock<std::mutex> locker(mutex_);
   // check the context second time,
   // for avoid the case when another thread, already created instance
   // when current thread was locked
-  if (context_.Get() != nullptr) {
-    PtrHolder<WeakContext<T>> weak_context =
-        MakePtrHolder<WeakContext<T>>(context_.Get()->GetInstance());
-    return weak_context;
+  if (is_created_.load(std::memory_order_relaxed)) {
+    return PtrHolder<BaseContext<T>>(weak_context_->AddRef());
   }
 
-  PtrHolder<Context<T>> context = MakePtrHolder<Context<T>>();
-  BaseInstanceManager<T>::Create(context.Get());
+  MemoryResource* resource = BaseInstanceManager<T>::resource_;
+  if (weak_context_ == nullptr) {
+    // it is created before the object, the object is not created in vain
+    weak_context_ = NewInResource<WeakRef>(resource, resource, nullptr);
+  }
+
+  PtrHolder<Context<T>> context = BaseInstanceManager<T>::MakeContext();
+  if (weak_context_ == nullptr || context.Get() == nullptr) {
+    // no memory for the contexts
+    return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+  }
+  BaseInstanceManager<T>::Create(context.Get(), create_);
   if (context->IsValid()) {
     context_ = std::move(context);
-    PtrHolder<WeakContext<T>> weak_context =
-        MakePtrHolder<WeakContext<T>>(context_.Get()->GetInstance());
-    return weak_context;
+    weak_context_->SetInstance(context_.Get()->GetInstance());
+    is_created_.store(true, std::memory_order_release);
+    return PtrHolder<BaseContext<T>>(weak_context_->AddRef());
   } else {
     return context;
   }
@@ -31,8 +31,8 @@
 #define CPP_TOOL_KIT_FACTORY_POOL_INSTANCE_MANAGER_H_
 
 #include <mutex>
-#include <queue>
-#include <unordered_map>
+#include <new>
+#include <vector>
 
 #include "base_instance_manager.h"
 #include "context/pool_context.h"
@@ -44,74 +44,112 @@ namespace engine {
 /// If the pool is emty this manager creates new one, if the pool is full
 /// the object will be destroyed
 /// @tparam T type of managed object
-template <typename T>
+/// @tparam F type of creator, callable as 'T*(Resolver&)'
+template <typename T, typename F = CreateFunction<T>>
 class SoftPoolInstanceManager : public BaseInstanceManager<T>,
                                 public AbstractPoolInstancePutback {
  public:
   /// @brief Create instance manager
-  /// @param class_name_key [in] unique key for current manager
-  /// @param create [in] function for create instance of managed object
+  /// @param key [in] unique key for a given object type
+  /// @param create [in] creator of instance of managed object
   /// @param core [in] pointer to the core_ with registered objects
   /// @param pool_size [in] size of pool object
+  /// @param resource [in] source of memory for contexts
   SoftPoolInstanceManager(
-      std::string class_name_key,
-      std::function<T*(cpptoolkit::factory::Resolver&)>&& create,
-      cpptoolkit::factory::Core* core, uint32_t pool_size) noexcept
-      : BaseInstanceManager<T>(class_name_key, std::move(create), core),
-        size_(pool_size){};
-
-  virtual ~SoftPoolInstanceManager() noexcept = default;
+      std::string key, F create,
+      cpptoolkit::factory::Core* core, uint32_t pool_size,
+      MemoryResource* resource = NewDeleteResource()) noexcept
+      : BaseInstanceManager<T>(key, core, resource),
+        create_(std::move(create)),
+        size_(pool_size),
+        queue_(ResourceAllocator<PoolContext<T>*>(resource)) {
+    // the allocator of the resource throws if there is no memory, then the
+    // pool keeps no instances
+    try {
+      queue_.reserve(pool_size);
+    } catch (const std::bad_alloc&) {
+      size_ = 0;
+    }
+  };
+
+  virtual ~SoftPoolInstanceManager() noexcept {
+    for (PoolContext<T>* pool_context : queue_) {
+      DeleteInResource(BaseInstanceManager<T>::resource_, pool_context);
+    }
+  };
 
   PtrHolder<BaseContext<T>> Get() noexcept override;
+
+  void Compile() noexcept override {
+    CompileCreator(create_, BaseInstanceManager<T>::core_);
+  };
+
+  size_t DeclaredDependencyCount() noexcept override {
+    return CreatorDependencyCount(create_);
+  };
+
+  AInstanceManager* DeclaredDependency(size_t index) noexcept override {
+    return CreatorDependency(create_, index);
+  };
+
+  bool DeclaresDependencies() noexcept override {
+    return CreatorDeclaresDependencies(create_);
+  };
   void Callback(uintptr_t key) noexcept override;
 
  private:
+  F create_;
   uint32_t size_;
-  std::queue<uintptr_t> queue_;
-  std::unordered_map<uintptr_t, PtrHolder<Context<T>>> index_;
+  // free objects in the pool, owns them
+  std::vector<PoolContext<T>*, ResourceAllocator<PoolContext<T>*>> queue_;
 
   // thread section
   std::mutex mutex_;
 };
 
-template <typename T>
-inline PtrHolder<BaseContext<T>> SoftPoolInstanceManager<T>::Get() noexcept {
-  std::unique_lock<std::mutex> locker(mutex_);
-
-  if (!queue_.empty()) {  // Get istance from pool
-    uintptr_t key = queue_.front();
-    const auto it = index_.find(key);
-    PtrHolder<PoolContext<T>> ctx =
-        MakePtrHolder<PoolContext<T>>(this, it->second.Get(), key);
-    queue_.pop();
-    return ctx;
+template <typename T, typename F>
+inline PtrHolder<BaseContext<T>> SoftPoolInstanceManager<T, F>::Get() noexcept {
+  {
+    std::unique_lock<std::mutex> locker(mutex_);
+    if (!queue_.empty()) {  // Get istance from pool
+      PoolContext<T>* pool_context = queue_.back();
+      queue_.pop_back();
+      return PtrHolder<BaseContext<T>>(pool_context);
+    }
   }
 
   // Create new instance
-  PtrHolder<Context<T>> context = MakePtrHolder<Context<T>>();
-  BaseInstanceManager<T>::Create(context.Get());
+  PtrHolder<Context<T>> context = BaseInstanceManager<T>::MakeContext();
+  if (context.Get() == nullptr) {  // no memory for the context
+    return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+  }
+  BaseInstanceManager<T>::Create(context.Get(), create_);
 
   if (!context->IsValid()) {
     return context;
   }
 
-  Context<T>* context_ptr = context.Get();
-  uintptr_t key = reinterpret_cast<uintptr_t>(context_ptr);
-  PtrHolder<PoolContext<T>> ctx =
-      MakePtrHolder<PoolContext<T>>(this, context_ptr, key);
-  index_.emplace(key, std::move(context));
-  return ctx;
+  PoolContext<T>* pool_context = NewInResource<PoolContext<T>>(
+      BaseInstanceManager<T>::resource_, this, std::move(context));
+  if (pool_context == nullptr) {
+    return PtrHolder<BaseContext<T>>(NoMemoryContext<T>());
+  }
+
+  return PtrHolder<BaseContext<T>>(pool_context);
 }
 
-template <typename T>
-inline void SoftPoolInstanceManager<T>::Callback(uintptr_t key) noexcept {
-  std::unique_lock<std::mutex> locker(mutex_);
-  if (queue_.size() < size_) {
-    queue_.push(key);
-    return;
+template <typename T, typename F>
+inline void SoftPoolInstanceManager<T, F>::Callback(uintptr_t key) noexcept {
+  PoolContext<T>* pool_context = reinterpret_cast<PoolContext<T>*>(key);
+  {
+    std::unique_lock<std::mutex> locker(mutex_);
+    if (queue_.size() < size_) {
+      queue_.push_back(pool_context);
+      return;
+    }
   }
 
-  index_.erase(key);
+  DeleteInResource(BaseInstanceManager<T>::resource_, pool_context);
 }
 
 }  // namespace engine
@@ -0,0 +1,302 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_STATIC_CORE_H_
+#define CPP_TOOL_KIT_FACTORY_STATIC_CORE_H_
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "manager/lock_pool_instance_manager.h"
+#include "manager/multiple_instance_manager.h"
+#include "manager/single_instance_manager.h"
+#include "manager/soft_pool_instance_manager.h"
+#include "tool/arena.h"
+#include "tool/common.h"
+#include "tool/resolution_scope.h"
+#include "tool/type_list.h"
+#include "u_ptr.h"
+
+namespace cpptoolkit {
+namespace factory {
+
+// Bindings for StaticCore, every binding creates the object with pointers to
+// its dependencies (other bound types) as constructor arguments. The slot of
+// the binding keeps the instance manager with the creator of the StaticCore
+// as its template parameter, so the creator is not type erased
+
+/// @brief Bind type as multiple instance
+/// @tparam I type of managed object (the type for 'Get<I>()')
+/// @tparam Impl type of created object, inherits I
+/// @tparam ...Deps types of constructor arguments
+template <typename I, typename Impl, typename... Deps>
+struct Bind {
+  typedef I Interface;
+  typedef Impl Implementation;
+  typedef engine::TypeList<Deps...> Dependencies;
+
+  /// @brief Storage of the instance manager
+  /// @tparam F type of creator, callable as 'I*(Resolver&)'
+  template <typename F>
+  struct Slot {
+    Slot(F create) noexcept
+        : manager(engine::DEFAULT_KEY, std::move(create), nullptr){};
+    engine::MultipleInstanceManager<I, F> manager;
+  };
+};
+
+/// @brief Bind type as single instance
+/// @tparam T type of managed object
+/// @tparam ...Deps types of constructor arguments
+template <typename T, typename... Deps>
+struct Single {
+  typedef T Interface;
+  typedef T Implementation;
+  typedef engine::TypeList<Deps...> Dependencies;
+
+  /// @brief Storage of the instance manager
+  /// @tparam F type of creator, callable as 'T*(Resolver&)'
+  template <typename F>
+  struct Slot {
+    Slot(F create) noexcept
+        : manager(engine::DEFAULT_KEY, std::move(create), nullptr){};
+    engine::SingleInstanceManager<T, F> manager;
+  };
+};
+
+/// @brief Bind type as lock pool instance
+/// @tparam T type of managed object
+/// @tparam N pool size
+/// @tparam ...Deps types of constructor arguments
+template <typename T, uint32_t N, typename... Deps>
+struct LockPool {
+  static_assert(N > 0, "pool size can not be 0");
+
+  typedef T Interface;
+  typedef T Implementation;
+  typedef engine::TypeList<Deps...> Dependencies;
+
+  /// @brief Storage of the instance manager
+  /// @tparam F type of creator, callable as 'T*(Resolver&)'
+  template <typename F>
+  struct Slot {
+    Slot(F create) noexcept
+        : manager(engine::DEFAULT_KEY, std::move(create), nullptr, N){};
+    engine::LockPoolInstanceManager<T, F> manager;
+  };
+};
+
+/// @brief Bind type as soft pool instance
+/// @tparam T type of managed object
+/// @tparam N pool size
+/// @tparam ...Deps types of constructor arguments
+template <typename T, uint32_t N, typename... Deps>
+struct SoftPool {
+  static_assert(N > 0, "pool size can not be 0");
+
+  typedef T Interface;
+  typedef T Implementation;
+  typedef engine::TypeList<Deps...> Dependencies;
+
+  /// @brief Storage of the instance manager
+  /// @tparam F type of creator, callable as 'T*(Resolver&)'
+  template <typename F>
+  struct Slot {
+    Slot(F create) noexcept
+        : manager(engine::DEFAULT_KEY, std::move(create), nullptr, N){};
+    engine::SoftPoolInstanceManager<T, F> manager;
+  };
+};
+
+namespace engine {
+
+/// @brief Find binding for the type (compile time)
+/// @tparam T type of managed object
+/// @tparam ...Bindings bindings of StaticCore
+/// 'type' is the binding or 'void' if the type is not bound, 'count' is the
+/// number of bindings of the type
+template <typename T, typename... Bindings>
+struct FindBinding {
+  typedef void type;
+  static const size_t count = 0;
+};
+
+template <typename T, typename B, typename... Rest>
+struct FindBinding<T, B, Rest...> {
+  typedef typename std::conditional<
+      std::is_same<T, typename B::Interface>::value, B,
+      typename FindBinding<T, Rest...>::type>::type type;
+  static const size_t count =
+      FindBinding<T, Rest...>::count +
+      (std::is_same<T, typename B::Interface>::value ? 1 : 0);
+};
+
+/// @brief Creator of the bound object, it is a named type (unlike a lambda),
+/// so it can be the template parameter of the slot
+/// @tparam C type of StaticCore
+/// @tparam B binding
+template <typename C, typename B>
+struct StaticCreator {
+  C* core;
+
+  typename B::Interface* operator()(Resolver& resolver) const {
+    return core->template CreateInstance<typename B::Implementation>(
+        resolver, typename B::Dependencies());
+  };
+};
+
+}  // namespace engine
+
+/// Registry of objects resolved at compile time. Every type is bound once
+/// (without keys), instance managers are stored as members and 'Get<T>()'
+/// calls the manager without lookup and virtual dispatch. A request of not
+/// bound type fails to compile.
+/// Example: StaticCore<Single<NetLogger>, LockPool<DbLogger, 10>,
+///                     Bind<AbstractLogger, ComplexLogger, NetLogger, DbLogger>>
+/// @tparam ...Bindings Bind, Single, LockPool or SoftPool
+template <typename... Bindings>
+class StaticCore
+    : private Bindings::template Slot<
+          engine::StaticCreator<StaticCore<Bindings...>, Bindings>>... {
+  template <typename B>
+  using Creator = engine::StaticCreator<StaticCore, B>;
+
+  template <typename B>
+  using SlotOf = typename B::template Slot<Creator<B>>;
+
+  template <typename C, typename B>
+  friend struct engine::StaticCreator;
+
+ public:
+  StaticCore() noexcept : SlotOf<Bindings>(Creator<Bindings>{this})...{};
+
+  // Creators keep pointer to the core, so it can not be moved or copied
+  StaticCore(const StaticCore&) = delete;
+  StaticCore(StaticCore&&) = delete;
+  StaticCore& operator=(const StaticCore&) = delete;
+  StaticCore& operator=(StaticCore&&) = delete;
+
+  /// @brief Get context with managed object
+  /// @tparam T type of managed object
+  /// @return unique_ptr with BaseContext instance of managed object
+  template <typename T>
+  engine::PtrHolder<engine::BaseContext<T>> GetContext() noexcept;
+
+  /// @brief Get instance of BL object in RAII wrapper
+  /// @tparam T type of managed object
+  /// @return Instance of BL object in UPtr wrapper
+  template <typename T>
+  UPtr<T> Get() noexcept;
+
+ private:
+  /// @brief Binding of the type, checks that the type is bound once
+  /// @tparam T type of managed object
+  template <typename T>
+  struct BindingOf {
+    typedef engine::FindBinding<T, Bindings...> Find;
+    static_assert(Find::count != 0, "Type is not bound in StaticCore");
+    static_assert(Find::count < 2, "Type is bound in StaticCore twice");
+
+    typedef SlotOf<typename Find::type> Slot;
+    typedef decltype(Slot::manager) Manager;
+  };
+
+  template <typename Impl, typename... Deps>
+  Impl* CreateInstance(Resolver& resolver,
+                       engine::TypeList<Deps...>);
+
+  template <typename Impl, typename Tuple, size_t... I>
+  static Impl* Construct(Resolver& resolver, Tuple& dependencies,
+                         engine::IndexSequence<I...>);
+
+  template <typename T>
+  T* Resolve(Resolver& resolver) noexcept;
+};
+
+// Implementation
+
+template <typename... Bindings>
+template <typename T>
+inline engine::PtrHolder<engine::BaseContext<T>>
+StaticCore<Bindings...>::GetContext() noexcept {
+  typedef typename BindingOf<T>::Manager Manager;
+
+  // the object is the root of a new tree, even if it is got by the creator
+  // of another object
+  engine::ArenaScope arena_scope(nullptr);
+  engine::SuspendedResolutionScope resolution_scope;
+  Manager& manager = static_cast<typename BindingOf<T>::Slot&>(*this).manager;
+  return manager.Manager::Get();  // qualified call, no virtual dispatch
+}
+
+template <typename... Bindings>
+template <typename T>
+inline UPtr<T> StaticCore<Bindings...>::Get() noexcept {
+  return UPtr<T>(GetContext<T>());
+}
+
+template <typename... Bindings>
+template <typename Impl, typename... Deps>
+inline Impl* StaticCore<Bindings...>::CreateInstance(
+    Resolver& resolver, engine::TypeList<Deps...>) {
+  // braced list keeps the order of resolution from left to right
+  std::tuple<Deps*...> instances{Resolve<Deps>(resolver)...};
+  if (!resolver.is_valid_dependency_context_) {
+    return nullptr;  // the context already has error
+  }
+
+  return Construct<Impl>(resolver, instances,
+                         engine::MakeIndexSequence<sizeof...(Deps)>());
+}
+
+template <typename... Bindings>
+template <typename Impl, typename Tuple, size_t... I>
+inline Impl* StaticCore<Bindings...>::Construct(
+    Resolver& resolver, Tuple& dependencies, engine::IndexSequence<I...>) {
+  return resolver.Construct<Impl>(std::get<I>(dependencies)...);
+}
+
+template <typename... Bindings>
+template <typename T>
+inline T* StaticCore<Bindings...>::Resolve(Resolver& resolver) noexcept {
+  if (!resolver.is_valid_dependency_context_) {
+    return nullptr;
+  }
+
+  // the dependency is a part of the current tree and shares its arena
+  typedef typename BindingOf<T>::Manager Manager;
+  Manager& manager = static_cast<typename BindingOf<T>::Slot&>(*this).manager;
+  return resolver.Add<T>(manager.Manager::Get());
+}
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_STATIC_CORE_H_
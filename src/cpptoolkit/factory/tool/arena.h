@@ -0,0 +1,219 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_ARENA_H_
+#define CPP_TOOL_KIT_FACTORY_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "memory_resource.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// Bump allocator for objects which are destroyed together (contexts of one
+/// dependency tree). Memory is taken from the first chunk (allocated with the
+/// arena) and from extra chunks if the first one is full, 'Deallocate' does
+/// nothing, all memory is returned to the resource on 'Destroy()'. The arena
+/// is not thread safe, the arena of the current thread is set by
+/// 'ArenaScope'.
+class Arena {
+ public:
+  /// @brief Default size of the first chunk
+  static const size_t kDefaultSize = 1024;
+
+  /// @brief Create arena
+  /// @param size [in] size of the first chunk
+  /// @param resource [in] source of memory
+  /// @return Pointer to arena or nullptr if there is no memory
+  static Arena* Create(size_t size, MemoryResource* resource) noexcept;
+
+  /// @brief Delete arena and return all its memory to the resource
+  /// @param arena [in] pointer to arena or nullptr
+  static void Destroy(Arena* arena) noexcept;
+
+  /// @brief Get arena of the current thread
+  /// @return Pointer to arena or nullptr
+  static Arena* Current() noexcept { return CurrentRef(); };
+
+  /// @brief Allocate memory block
+  /// @param size [in] size of the block
+  /// @param alignment [in] alignment of the block
+  /// @return Pointer to the block or nullptr if there is no memory
+  void* Allocate(size_t size, size_t alignment) noexcept;
+
+  /// @brief Number of bytes used by all allocations, the estimate of the
+  /// first chunk for the next arena of the same tree
+  /// @return Number of bytes
+  size_t Used() const noexcept { return used_; };
+
+  // Ban RAII operations
+  Arena(const Arena&) = delete;
+  Arena(Arena&& other) = delete;
+  Arena& operator=(Arena&& other) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+ private:
+  friend class ArenaScope;
+
+  struct Chunk {
+    Chunk* next;
+    size_t size;  // size of the chunk with the header
+  };
+
+  static const size_t kAlignment = alignof(std::max_align_t);
+  static const size_t kHeaderSize =
+      (sizeof(Chunk) + kAlignment - 1) / kAlignment * kAlignment;
+
+  Arena(MemoryResource* resource, size_t size) noexcept
+      : resource_(resource),
+        size_(size),
+        chunks_(nullptr),
+        current_(reinterpret_cast<char*>(this) + ArenaSize()),
+        end_(reinterpret_cast<char*>(this) + size),
+        used_(0){};
+
+  ~Arena() noexcept = default;
+
+  static Arena*& CurrentRef() noexcept {
+    static thread_local Arena* current = nullptr;
+    return current;
+  };
+
+  static char* Align(char* ptr, size_t alignment) noexcept;
+
+  // size of the arena header before the first chunk
+  static size_t ArenaSize() noexcept;
+
+ private:
+  MemoryResource* resource_;
+  size_t size_;  // size of the arena with the first chunk
+  Chunk* chunks_;  // extra chunks
+  char* current_;
+  char* end_;
+  size_t used_;
+};
+
+/// @brief Set arena of the current thread for a scope, the previous arena is
+/// restored at the end of the scope
+class ArenaScope {
+ public:
+  /// @brief Set arena
+  /// @param arena [in] pointer to arena or nullptr, objects created in the
+  /// scope do not use arena in the last case
+  explicit ArenaScope(Arena* arena) noexcept : previous_(Arena::CurrentRef()) {
+    Arena::CurrentRef() = arena;
+  };
+
+  ~ArenaScope() noexcept { Arena::CurrentRef() = previous_; };
+
+  // Ban RAII operations
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+ private:
+  Arena* previous_;
+};
+
+// Implementation
+
+inline Arena* Arena::Create(size_t size, MemoryResource* resource) noexcept {
+  size += ArenaSize();
+  void* memory = resource->Allocate(size, kAlignment);
+  if (memory == nullptr) {
+    return nullptr;
+  }
+
+  return new (memory) Arena(resource, size);
+}
+
+inline void Arena::Destroy(Arena* arena) noexcept {
+  if (arena == nullptr) {
+    return;
+  }
+
+  MemoryResource* resource = arena->resource_;
+  Chunk* chunk = arena->chunks_;
+  while (chunk != nullptr) {
+    Chunk* next = chunk->next;
+    resource->Deallocate(chunk, chunk->size, kAlignment);
+    chunk = next;
+  }
+
+  const size_t size = arena->size_;
+  arena->~Arena();
+  resource->Deallocate(arena, size, kAlignment);
+}
+
+inline void* Arena::Allocate(size_t size, size_t alignment) noexcept {
+  char* block = Align(current_, alignment);
+  if (block > end_ || size > static_cast<size_t>(end_ - block)) {
+    // the next chunk is twice as big as the previous one
+    const size_t previous = chunks_ != nullptr ? chunks_->size : size_;
+    size_t chunk_size = kHeaderSize + size + alignment;
+    if (chunk_size < previous * 2) {
+      chunk_size = previous * 2;
+    }
+
+    void* memory = resource_->Allocate(chunk_size, kAlignment);
+    if (memory == nullptr) {
+      return nullptr;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->next = chunks_;
+    chunk->size = chunk_size;
+    chunks_ = chunk;
+    current_ = static_cast<char*>(memory) + kHeaderSize;
+    end_ = static_cast<char*>(memory) + chunk_size;
+    block = Align(current_, alignment);
+  }
+
+  used_ += static_cast<size_t>(block - current_) + size;
+  current_ = block + size;
+  return block;
+}
+
+inline size_t Arena::ArenaSize() noexcept {
+  return (sizeof(Arena) + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+inline char* Arena::Align(char* ptr, size_t alignment) noexcept {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  return ptr + ((alignment - address % alignment) % alignment);
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_ARENA_H_
@@ -31,14 +31,23 @@
 #define CPP_TOOL_KIT_FACTORY_BUILD_ITEM_H_
 
 #include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include "../handle.h"
 #include "../manager/lock_pool_instance_manager.h"
 #include "../manager/multiple_instance_manager.h"
 #include "../manager/single_instance_manager.h"
 #include "../manager/soft_pool_instance_manager.h"
 #include "common.h"
+#include "creation_frame.h"
+#include "executor.h"
 #include "instance_count_option_enum.h"
+#include "memory_resource.h"
+#include "resolution_scope.h"
+#include "type_list.h"
 
 namespace cpptoolkit {
 namespace factory {
@@ -52,6 +61,33 @@ class CoreExtension;
 template <typename T, typename... Args>
 PtrHolder<T> MakePtrHolder(Args&&... args) noexcept;
 
+/// @brief Get helper which takes the properties of the registration when
+/// it can not be kept, they are not used: the registration fails on build.
+/// The helper is one for the type and the thread, the previous one is
+/// destroyed and a new one is created in the same memory
+/// @tparam Item type of helper
+/// @param ...args [in] arguments for Item constructor
+/// @return Reference to helper
+template <typename Item, typename... Args>
+inline Item& DetachedItem(Args&&... args) noexcept {
+  static thread_local struct Holder {
+    ~Holder() noexcept {
+      if (item != nullptr) {
+        item->~Item();
+      }
+    };
+
+    typename std::aligned_storage<sizeof(Item), alignof(Item)>::type storage;
+    Item* item;
+  } holder{};
+
+  if (holder.item != nullptr) {
+    holder.item->~Item();
+  }
+  holder.item = new (&holder.storage) Item(std::forward<Args>(args)...);
+  return *holder.item;
+}
+
 /// @brief Interface for collecting data for registration object in Core
 class ABuildItem {
  public:
@@ -67,19 +103,363 @@ class ABuildItem {
   virtual const std::string& Error() noexcept = 0;
 };
 
+/// @brief Creator of the object from its constructor arguments, the
+/// dependencies are registered with the default key and passed to the
+/// constructor as pointers. The list is known at compile time, so the
+/// dependencies are resolved in one pass with one check of errors. When the
+/// registration is closed the creator keeps handles of the dependencies and
+/// skips the lookup in Core. With the executor the dependencies are created
+/// in parallel, except inside a task of the executor, where they are created
+/// one after another. Each dependency created in parallel (the one in the
+/// current thread too) is the root of its own resolution: it has no arena and
+/// does not share objects with the tree of the object. Without the executor the object can be created from
+/// the contexts of the dependencies by the resolution plan of the tree
+/// @tparam T type of created object
+/// @tparam ...Deps types of constructor arguments
+template <typename T, typename... Deps>
+struct TypeCreator {
+  typedef TypeList<Deps...> Dependencies;
+
+  TypeCreator() noexcept : executor_(nullptr){};
+
+  T* operator()(Resolver& resolver) const {
+    // a task does not wait for other tasks, a bounded executor could have no
+    // free thread for them
+    if (executor_ != nullptr && !TaskScope::IsInTask()) {
+      return CreateInParallel(resolver, MakeIndexSequence<sizeof...(Deps)>());
+    }
+
+    return Create(resolver, MakeIndexSequence<sizeof...(Deps)>());
+  };
+
+  /// @brief Resolve handles of the dependencies
+  /// @param core [in] pointer to the core_ with registered objects
+  void Compile(cpptoolkit::factory::Core* core) noexcept {
+    (void)core;  // it is not used by the empty list of dependencies
+    handles_ = std::make_tuple(GetHandle<Deps>(core)...);
+  };
+
+  /// @brief Create the dependencies in parallel
+  /// @param executor [in] executor of tasks or nullptr to create them one
+  /// after another
+  void SetExecutor(Executor* executor) noexcept {
+    // one dependency is created in the current thread
+    executor_ = sizeof...(Deps) > 1 ? executor : nullptr;
+  };
+
+  /// @brief Check if the object is created from the contexts of the
+  /// dependencies, the parallel creation needs the resolver
+  /// @return Check result
+  bool CreatesFromContexts() const noexcept { return executor_ == nullptr; };
+
+  /// @brief Create the object from the contexts of the dependencies created
+  /// by the resolution plan
+  /// @param resolver [in] resolver of the object context
+  /// @param dependencies [in] contexts in the order of arguments, they are
+  /// moved to the object context
+  /// @return Pointer to the object or nullptr if a dependency has error
+  T* CreateFrom(Resolver& resolver, AContext** dependencies) const {
+    return CreateFrom(resolver, dependencies,
+                      MakeIndexSequence<sizeof...(Deps)>());
+  };
+
+  /// @brief Get manager of the dependency, it is known after 'Compile()'
+  /// @param index [in] index of dependency
+  /// @return Manager or nullptr if the dependency is not registered
+  AInstanceManager* Dependency(size_t index) const noexcept {
+    return Dependency(index, MakeIndexSequence<sizeof...(Deps)>());
+  };
+
+ private:
+  /// @brief Creation of one dependency in the executor
+  template <typename D>
+  struct Task {
+    Task(const Handle<D>& handle, cpptoolkit::factory::Core* core,
+         TaskLatch* latch) noexcept
+        : handle(handle),
+          core(core),
+          latch(latch),
+          frame(CreationFrame::Current()),
+          context(nullptr){};
+
+    static void Run(void* argument) noexcept {
+      TaskScope task_scope;
+      CreateContext(argument);
+    };
+
+    static void CreateContext(void* argument) noexcept {
+      Task<D>* task = static_cast<Task<D>*>(argument);
+      {
+        // the arena and the resolution scope of the tree are not thread
+        // safe, all dependencies are roots, whatever thread creates them
+        ArenaScope arena_scope(nullptr);
+        SuspendedResolutionScope resolution_scope;
+        // the objects in progress are the same as in the creating thread
+        CreationChainScope chain_scope(task->frame);
+        task->context = task->handle.IsValid()
+                            ? GetContext<D>(task->handle)
+                            : GetContext<D>(task->core);
+      }
+      task->latch->CountDown();
+    };
+
+    Handle<D> handle;
+    cpptoolkit::factory::Core* core;
+    TaskLatch* latch;
+    const CreationFrame* frame;  // chain of the creating thread
+    PtrHolder<BaseContext<D>> context;
+  };
+
+  template <size_t... I>
+  AInstanceManager* Dependency(size_t index,
+                               IndexSequence<I...>) const noexcept {
+    // the first item allows the empty list of dependencies
+    AInstanceManager* managers[] = {nullptr,
+                                    std::get<I>(handles_).Manager()...};
+    return index < sizeof...(Deps) ? managers[index + 1] : nullptr;
+  };
+
+  template <size_t... I>
+  T* CreateInParallel(Resolver& resolver, IndexSequence<I...>) const {
+    TaskLatch latch(sizeof...(Deps));
+    std::tuple<Task<Deps>...> tasks{
+        Task<Deps>(std::get<I>(handles_), resolver.core_, &latch)...};
+    // the last dependency is created in the current thread
+    int start[] = {(Start(std::get<I>(tasks), I + 1 == sizeof...(Deps)), 0)...};
+    (void)start;
+    latch.Wait();
+
+    // the contexts are added in the order of arguments, so the error is the
+    // same as for creation one after another
+    resolver.Reserve(sizeof...(Deps));
+    std::tuple<Deps*...> instances{
+        Add(resolver, std::move(std::get<I>(tasks).context))...};
+    if (!resolver.is_valid_dependency_context_) {
+      return nullptr;  // the context already has error
+    }
+
+    return resolver.Construct<T>(std::get<I>(instances)...);
+  };
+
+  template <typename D>
+  void Start(Task<D>& task, bool in_current_thread) const noexcept {
+    if (in_current_thread) {
+      Task<D>::CreateContext(&task);
+      return;
+    }
+
+    executor_->Execute(&Task<D>::Run, &task);
+  };
+
+  template <size_t... I>
+  T* Create(Resolver& resolver, IndexSequence<I...>) const {
+    resolver.Reserve(sizeof...(Deps));
+    // braced list keeps the order of resolution from left to right
+    std::tuple<Deps*...> instances{Resolve(resolver, std::get<I>(handles_))...};
+    if (!resolver.is_valid_dependency_context_) {
+      return nullptr;  // the context already has error
+    }
+
+    return resolver.Construct<T>(std::get<I>(instances)...);
+  };
+
+  template <size_t... I>
+  T* CreateFrom(Resolver& resolver, AContext** dependencies,
+                IndexSequence<I...>) const {
+    (void)dependencies;  // it is not used by the empty list of dependencies
+    resolver.Reserve(sizeof...(Deps));
+    std::tuple<Deps*...> instances{Add(
+        resolver, PtrHolder<BaseContext<Deps>>(
+                      static_cast<BaseContext<Deps>*>(dependencies[I])))...};
+    if (!resolver.is_valid_dependency_context_) {
+      return nullptr;  // the context already has error
+    }
+
+    return resolver.Construct<T>(std::get<I>(instances)...);
+  };
+
+  template <typename D>
+  static D* Resolve(Resolver& resolver, const Handle<D>& handle) noexcept {
+    if (!resolver.is_valid_dependency_context_) {
+      return nullptr;  // a dependency failed, the object is not created
+    }
+
+    // the handle is empty before 'Compile()' or if the type is not
+    // registered, the lookup gives the full error
+    return handle.IsValid() ? resolver.Resolve<D>(handle)
+                            : resolver.Resolve<D>();
+  };
+
+  template <typename D>
+  static D* Add(Resolver& resolver,
+                PtrHolder<BaseContext<D>>&& context) noexcept {
+    if (!resolver.is_valid_dependency_context_) {
+      return nullptr;  // the context is released, it is not needed
+    }
+
+    return resolver.Add<D>(std::move(context));
+  };
+
+ private:
+  std::tuple<Handle<Deps>...> handles_;
+  Executor* executor_;
+};
+
+/// @brief Creator of the object registered as its interface
+/// @tparam I type of interface
+/// @tparam F type of creator of the implementation
+template <typename I, typename F>
+struct AsCreator {
+  typedef F Implementation;
+
+  I* operator()(Resolver& resolver) { return create(resolver); };
+
+  F create;
+};
+
+/// @brief Bind the creator to managers of its dependencies
+/// @param create [in] creator of instance
+/// @param core [in] pointer to the core_ with registered objects
+template <typename T, typename... Deps>
+inline void CompileCreator(TypeCreator<T, Deps...>& create,
+                           cpptoolkit::factory::Core* core) noexcept {
+  create.Compile(core);
+}
+
+/// @brief Bind the creator of the implementation to managers of its
+/// dependencies
+/// @param create [in] creator of instance
+/// @param core [in] pointer to the core_ with registered objects
+template <typename I, typename F>
+inline void CompileCreator(AsCreator<I, F>& create,
+                           cpptoolkit::factory::Core* core) noexcept {
+  CompileCreator(create.create, core);
+}
+
+/// @brief Number of dependencies declared by the creator
+/// @param create [in] creator of instance
+/// @return Number of dependencies
+template <typename T, typename... Deps>
+inline size_t CreatorDependencyCount(
+    const TypeCreator<T, Deps...>& /*create*/) noexcept {
+  return sizeof...(Deps);
+}
+
+template <typename I, typename F>
+inline size_t CreatorDependencyCount(const AsCreator<I, F>& create) noexcept {
+  return CreatorDependencyCount(create.create);
+}
+
+/// @brief Get manager of dependency declared by the creator
+/// @param create [in] creator of instance
+/// @param index [in] index of dependency
+/// @return Manager or nullptr if the dependency is not registered
+template <typename T, typename... Deps>
+inline AInstanceManager* CreatorDependency(
+    const TypeCreator<T, Deps...>& create, size_t index) noexcept {
+  return create.Dependency(index);
+}
+
+template <typename I, typename F>
+inline AInstanceManager* CreatorDependency(const AsCreator<I, F>& create,
+                                           size_t index) noexcept {
+  return CreatorDependency(create.create, index);
+}
+
+/// @brief Check if the creator declares all dependencies of the object
+/// @param create [in] creator of instance
+/// @return Check result
+template <typename T, typename... Deps>
+inline bool CreatorDeclaresDependencies(
+    const TypeCreator<T, Deps...>& /*create*/) noexcept {
+  return true;
+}
+
+template <typename I, typename F>
+inline bool CreatorDeclaresDependencies(
+    const AsCreator<I, F>& create) noexcept {
+  return CreatorDeclaresDependencies(create.create);
+}
+
+/// @brief Check if the creator makes the object from the contexts of its
+/// dependencies
+/// @param create [in] creator of instance
+/// @return false if the dependencies are created in parallel
+template <typename T, typename... Deps>
+inline bool CreatorCreatesFromContexts(
+    const TypeCreator<T, Deps...>& create) noexcept {
+  return create.CreatesFromContexts();
+}
+
+template <typename I, typename F>
+inline bool CreatorCreatesFromContexts(const AsCreator<I, F>& create) noexcept {
+  return CreatorCreatesFromContexts(create.create);
+}
+
+/// @brief Create the object from the contexts of its declared dependencies
+/// @param create [in] creator of instance
+/// @param resolver [in] resolver of the object context
+/// @param dependencies [in] contexts in the order of the dependencies
+/// @return Pointer to the object
+template <typename T, typename... Deps>
+inline T* CreateFromContexts(TypeCreator<T, Deps...>& create,
+                             Resolver& resolver, AContext** dependencies) {
+  return create.CreateFrom(resolver, dependencies);
+}
+
+template <typename I, typename F>
+inline I* CreateFromContexts(AsCreator<I, F>& create, Resolver& resolver,
+                             AContext** dependencies) {
+  return CreateFromContexts(create.create, resolver, dependencies);
+}
+
+/// @brief Set executor for parallel creation of dependencies, only the
+/// creator with known dependencies supports it
+/// @param create [in] creator of instance
+/// @param executor [in] executor of tasks
+/// @return false if the creator does not support it
+template <typename F>
+inline bool SetCreatorExecutor(F& /*create*/,
+                               Executor* /*executor*/) noexcept {
+  return false;
+}
+
+template <typename T, typename... Deps>
+inline bool SetCreatorExecutor(TypeCreator<T, Deps...>& create,
+                               Executor* executor) noexcept {
+  create.SetExecutor(executor);
+  return true;
+}
+
+template <typename I, typename F>
+inline bool SetCreatorExecutor(AsCreator<I, F>& create,
+                               Executor* executor) noexcept {
+  return SetCreatorExecutor(create.create, executor);
+}
+
 /// @brief Provides fluent interface for type registation
 /// @tparam T type of managed object
-template <typename T>
+/// @tparam F type of creator, callable as 'T*(Resolver&)', it is kept by the
+/// instance manager without type erasure
+template <typename T, typename F = CreateFunction<T>>
 class BuildItem : public ABuildItem {
  public:
   /// @brief Create instance
-  /// @param create [in] function for create instance of managed object
-  /// @tparam T Type of managed object
-  BuildItem(std::function<T*(Resolver&)>&& create) noexcept
-      : create_(std::move(create)),
+  /// @param create [in] creator of instance of managed object
+  BuildItem(F create) noexcept
+      : as_(nullptr),
+        create_(std::move(create)),
         count_option_(InstanceCountOptionEnum::kMultiple),
         key_(DEFAULT_KEY),
-        pool_size_(0){};
+        pool_size_(0),
+        cache_capacity_(Slab::kDefaultCapacity),
+        resource_(nullptr),
+        use_arena_(false),
+        share_(false),
+        executor_(nullptr),
+        is_no_memory_(false),
+        is_as_twice_(false),
+        is_reserved_key_(false){};
 
   virtual ~BuildItem() noexcept = default;
 
@@ -90,61 +470,165 @@ class BuildItem : public ABuildItem {
   /// @brief Set unique key for a given object type
   /// @param key [in] key value
   /// @return Pointer to current instance
-  BuildItem<T>& SetKey(const std::string& key) noexcept;
+  BuildItem<T, F>& SetKey(const Key& key) noexcept;
 
   // Count option section
 
   /// @brief Register as single instance
   /// @return Pointer to current instance
-  BuildItem<T>& AsSingleInstance() noexcept;
+  BuildItem<T, F>& AsSingleInstance() noexcept;
 
   /// @brief Register as multiple instance
   /// @return Pointer to current instance
-  BuildItem<T>& AsMultipleInstance() noexcept;
+  BuildItem<T, F>& AsMultipleInstance() noexcept;
 
   /// @brief Register as lock pool instance
   /// @param pool_size [in] pool size
   /// @return Pointer to current instance
-  BuildItem<T>& AsLockPoolInstance(uint32_t pool_size) noexcept;
+  BuildItem<T, F>& AsLockPoolInstance(uint32_t pool_size) noexcept;
 
   /// @brief Register as pool instance
   /// @param pool_size [in] pool size
   /// @return Pointer to current instance
-  BuildItem<T>& AsSoftPoolInstance(uint32_t pool_size) noexcept;
+  BuildItem<T, F>& AsSoftPoolInstance(uint32_t pool_size) noexcept;
+
+  /// @brief Set max number of cached memory blocks for contexts of the object
+  /// @param capacity [in] number of blocks, 0 disables the cache
+  /// @return Pointer to current instance
+  BuildItem<T, F>& SetCacheCapacity(uint32_t capacity) noexcept;
+
+  /// @brief Set source of memory for contexts of the object and for
+  /// instances created by 'Resolver::Construct()', by default the memory
+  /// resource of the Builder is used
+  /// @param resource [in] memory resource, must outlive the Core
+  /// @return Pointer to current instance
+  BuildItem<T, F>& SetMemoryResource(MemoryResource* resource) noexcept;
+
+  /// @brief Create the object and its multiple dependencies in one arena,
+  /// which is deleted with the object. The size of the arena is learned from
+  /// previous creations. Only for multiple instance
+  /// @return Pointer to current instance
+  BuildItem<T, F>& UseArena() noexcept;
+
+  /// @brief Create the object once in the tree of one top-level 'Get()' and
+  /// share it by all consumers in the tree. Only for multiple instance
+  /// @return Pointer to current instance
+  BuildItem<T, F>& ShareInResolution() noexcept;
+
+  /// @brief Create dependencies of the object in parallel, the object is
+  /// created after all of them. Only for objects registered with the list of
+  /// dependencies. Objects shared in resolution are not shared between
+  /// the parallel branches
+  /// @param executor [in] executor of tasks, must outlive the Core
+  /// @return Pointer to current instance
+  BuildItem<T, F>& ResolveInParallel(Executor* executor) noexcept;
+
+  /// @brief Register the object as its interface (or base class) instead of
+  /// own type, properties set before are kept. Call it before other
+  /// properties, the returned helper replaces the current one: properties
+  /// set on the current one after the call are ignored. The registration
+  /// fails on build if it is called twice
+  /// @tparam I type of interface
+  /// @return Reference to helper of the interface
+  template <typename I>
+  BuildItem<I, AsCreator<I, F>>& As() noexcept;
 
  private:
-  std::function<T*(Resolver&)> create_;
+  template <typename N, typename C>
+  friend class BuildItem;
+
+  PtrHolder<ABuildItem> as_;  // registration of the interface
+  F create_;
   InstanceCountOptionEnum count_option_;
   std::string key_;
   uint32_t pool_size_;  // only for pool instances
+  uint32_t cache_capacity_;
+  MemoryResource* resource_;  // nullptr - the resource of the Core
+  bool use_arena_;
+  bool share_;
+  Executor* executor_;    // nullptr - dependencies one after another
+  bool is_no_memory_;     // there was no memory for the interface helper
+  bool is_as_twice_;      // 'As()' was called again, the creator is moved
+  bool is_reserved_key_;  // the string key has the form of a number key
   std::string error_;
 };
 
 // Implementation
 
-template <typename T>
-bool BuildItem<T>::Build(CoreExtension* core) noexcept {
+template <typename T, typename F>
+bool BuildItem<T, F>::Build(CoreExtension* core) noexcept {
+  if (as_.Get() != nullptr && !is_as_twice_) {
+    return as_->Build(core);
+  }
+
   const std::string type_name = typeid(T).name();
+  if (is_as_twice_) {
+    error_ = type_name + ": registration as interface can be set only once";
+    return false;
+  }
+
+  if (is_no_memory_) {
+    error_ = type_name + ": no memory for registration as interface";
+    return false;
+  }
+
   if (key_.empty()) {
     error_ = type_name + ": key can not be empty";
     return false;
   }
 
-  std::string type_key = TypeKey<T>(key_);
+  if (is_reserved_key_) {
+    error_ = type_name + ": string key has the form of a number key";
+    return false;
+  }
+
+  if (use_arena_ && count_option_ != InstanceCountOptionEnum::kMultiple) {
+    error_ = type_name + ": arena can be used only for multiple instance";
+    return false;
+  }
+
+  if (share_ && count_option_ != InstanceCountOptionEnum::kMultiple) {
+    error_ = type_name + ": only multiple instance can be shared in resolution";
+    return false;
+  }
+
+  if (executor_ != nullptr && !SetCreatorExecutor(create_, executor_)) {
+    error_ = type_name + ": parallel resolution needs the list of dependencies";
+    return false;
+  }
+
+  // managers live in the memory of the Core, contexts in the memory of
+  // the registration
+  MemoryResource* core_resource = core->Resource();
+  MemoryResource* resource = resource_ != nullptr ? resource_ : core_resource;
 
   bool result = true;
   switch (count_option_) {
     case InstanceCountOptionEnum::kMultiple: {
-      PtrHolder<MultipleInstanceManager<T>> m_manager =
-          MakePtrHolder<MultipleInstanceManager<T>>(type_key, std::move(create_),
-                                               core);
+      PtrHolder<MultipleInstanceManager<T, F>> m_manager(
+          MakeResourceObject<MultipleInstanceManager<T, F>>(
+              core_resource, key_, std::move(create_), core, resource));
+      if (m_manager.Get() == nullptr) {
+        error_ = type_name + ": no memory for the instance manager";
+        return false;
+      }
+
+      m_manager->SetCacheCapacity(cache_capacity_);
+      m_manager->SetUseArena(use_arena_);
+      m_manager->SetShareInResolution(share_);
       result = core->Add(std::move(m_manager));
       break;
     }
     case InstanceCountOptionEnum::kSingle: {
-      PtrHolder<SingleInstanceManager<T>> s_manager =
-          MakePtrHolder<SingleInstanceManager<T>>(type_key, std::move(create_),
-                                             core);
+      PtrHolder<SingleInstanceManager<T, F>> s_manager(
+          MakeResourceObject<SingleInstanceManager<T, F>>(
+              core_resource, key_, std::move(create_), core, resource));
+      if (s_manager.Get() == nullptr) {
+        error_ = type_name + ": no memory for the instance manager";
+        return false;
+      }
+
+      s_manager->SetCacheCapacity(cache_capacity_);
       result = core->Add(std::move(s_manager));
       break;
     }
@@ -153,9 +637,16 @@ bool BuildItem<T>::Build(CoreExtension* core) noexcept {
         error_ = type_name + ": pool size can not be 0";
         return false;
       }
-      PtrHolder<SoftPoolInstanceManager<T>> p_manager =
-          MakePtrHolder<SoftPoolInstanceManager<T>>(type_key, std::move(create_),
-                                               core, pool_size_);
+      PtrHolder<SoftPoolInstanceManager<T, F>> p_manager(
+          MakeResourceObject<SoftPoolInstanceManager<T, F>>(
+              core_resource, key_, std::move(create_), core, pool_size_,
+              resource));
+      if (p_manager.Get() == nullptr) {
+        error_ = type_name + ": no memory for the instance manager";
+        return false;
+      }
+
+      p_manager->SetCacheCapacity(cache_capacity_);
       result = core->Add(std::move(p_manager));
       break;
     }
@@ -164,9 +655,16 @@ bool BuildItem<T>::Build(CoreExtension* core) noexcept {
         error_ = type_name + ": pool size can not be 0";
         return false;
       }
-      PtrHolder<LockPoolInstanceManager<T>> lp_manager =
-          MakePtrHolder<LockPoolInstanceManager<T>>(type_key, std::move(create_),
-                                               core, pool_size_);
+      PtrHolder<LockPoolInstanceManager<T, F>> lp_manager(
+          MakeResourceObject<LockPoolInstanceManager<T, F>>(
+              core_resource, key_, std::move(create_), core, pool_size_,
+              resource));
+      if (lp_manager.Get() == nullptr) {
+        error_ = type_name + ": no memory for the instance manager";
+        return false;
+      }
+
+      lp_manager->SetCacheCapacity(cache_capacity_);
       result = core->Add(std::move(lp_manager));
       break;
     }
@@ -182,43 +680,116 @@ bool BuildItem<T>::Build(CoreExtension* core) noexcept {
   return result;
 }
 
-template <typename T>
-const std::string& BuildItem<T>::Error() noexcept {
+template <typename T, typename F>
+const std::string& BuildItem<T, F>::Error() noexcept {
+  if (as_.Get() != nullptr && !is_as_twice_) {
+    return as_->Error();
+  }
+
   return error_;
 }
 
-template <typename T>
-BuildItem<T>& BuildItem<T>::SetKey(const std::string& key) noexcept {
-  key_ = key;
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::SetKey(const Key& key) noexcept {
+  key_.assign(key.Data(), key.Size());
+  is_reserved_key_ = key.IsReserved();
   return *this;
 }
 
-template <typename T>
-BuildItem<T>& BuildItem<T>::AsSingleInstance() noexcept {
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::AsSingleInstance() noexcept {
   count_option_ = InstanceCountOptionEnum::kSingle;
   return *this;
 }
 
-template <typename T>
-BuildItem<T>& BuildItem<T>::AsMultipleInstance() noexcept {
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::AsMultipleInstance() noexcept {
   count_option_ = InstanceCountOptionEnum::kMultiple;
   return *this;
 }
 
-template <typename T>
-BuildItem<T>& BuildItem<T>::AsLockPoolInstance(uint32_t pool_size) noexcept {
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::AsLockPoolInstance(
+    uint32_t pool_size) noexcept {
   count_option_ = InstanceCountOptionEnum::kLockPool;
   pool_size_ = pool_size;
   return *this;
 }
 
-template <typename T>
-BuildItem<T>& BuildItem<T>::AsSoftPoolInstance(uint32_t pool_size) noexcept {
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::AsSoftPoolInstance(
+    uint32_t pool_size) noexcept {
   count_option_ = InstanceCountOptionEnum::kSoftPool;
   pool_size_ = pool_size;
   return *this;
 }
 
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::SetCacheCapacity(
+    uint32_t capacity) noexcept {
+  cache_capacity_ = capacity;
+  return *this;
+}
+
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::SetMemoryResource(
+    MemoryResource* resource) noexcept {
+  resource_ = resource;
+  return *this;
+}
+
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::UseArena() noexcept {
+  use_arena_ = true;
+  return *this;
+}
+
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::ShareInResolution() noexcept {
+  share_ = true;
+  return *this;
+}
+
+template <typename T, typename F>
+BuildItem<T, F>& BuildItem<T, F>::ResolveInParallel(
+    Executor* executor) noexcept {
+  executor_ = executor;
+  return *this;
+}
+
+template <typename T, typename F>
+template <typename I>
+BuildItem<I, AsCreator<I, F>>& BuildItem<T, F>::As() noexcept {
+  static_assert(std::is_convertible<T*, I*>::value,
+                "The type must be convertible to the interface");
+  typedef BuildItem<I, AsCreator<I, F>> Item;
+  if (as_.Get() != nullptr || is_no_memory_) {
+    is_as_twice_ = true;
+    return DetachedItem<Item>(AsCreator<I, F>{std::move(create_)});
+  }
+
+  // the creator is moved to the helper only if there is memory for it
+  void* memory = ::operator new(sizeof(Item), std::nothrow);
+  if (memory == nullptr) {
+    is_no_memory_ = true;
+    return DetachedItem<Item>(AsCreator<I, F>{std::move(create_)});
+  }
+
+  Item* ptr = new (memory) Item(AsCreator<I, F>{std::move(create_)});
+  PtrHolder<Item> item(ptr);
+  ptr->count_option_ = count_option_;
+  ptr->key_ = key_;
+  ptr->is_reserved_key_ = is_reserved_key_;
+  ptr->pool_size_ = pool_size_;
+  ptr->cache_capacity_ = cache_capacity_;
+  ptr->resource_ = resource_;
+  ptr->use_arena_ = use_arena_;
+  ptr->share_ = share_;
+  ptr->executor_ = executor_;
+  as_ = std::move(item);
+  return *ptr;
+}
+
 }  // namespace engine
 }  // namespace factory
 }  // namespace cpptoolkit
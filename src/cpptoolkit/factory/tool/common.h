@@ -30,11 +30,28 @@
 #ifndef CPP_TOOL_KIT_FACTORY_COMMON_H_
 #define CPP_TOOL_KIT_FACTORY_COMMON_H_
 
+#include <atomic>
+#include <cstdint>
+#include <new>
 #include <string>
+#include <typeinfo>
+
+#include "key.h"
 
 namespace cpptoolkit {
 namespace factory {
 
+namespace engine {
+
+/// @brief Generate next unique number for the type
+/// @return Type number
+inline uint32_t NextTypeId() noexcept {
+  static std::atomic<uint32_t> counter(0);
+  return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace engine
+
 /// @brief Create instance
 /// @tparam T the type of object to create
 /// @tparam ...Args types of arguments for T
@@ -45,14 +62,28 @@ inline T* Create(Args&&... args) {
   return new T(std::forward<Args>(args)...);
 }
 
-/// @brief Generate unique key for managed object
+/// @brief Get unique number for managed object type, the number is assigned
+/// on first call and does not depend on RTTI
+/// @tparam T type of managed object
+/// @return Type number, the numbers are dense and start from 0
+template <typename T>
+inline uint32_t TypeId() noexcept {
+  static const uint32_t id = engine::NextTypeId();
+  return id;
+}
+
+/// @brief Generate human readable key for managed object (for messages)
 /// @tparam T type of managed object
 /// @param key [in] key value
-/// @return Key for managed object
+/// @return Key for managed object or empty string if there is no memory for it
 template <typename T>
-inline std::string TypeKey(const std::string& key) noexcept {
-  const std::string type_name = typeid(T).name();
-  return type_name + "/" + key;
+inline std::string TypeKey(const Key& key) noexcept {
+  try {
+    const std::string type_name = typeid(T).name();
+    return type_name + "/" + key.ToString();
+  } catch (const std::bad_alloc&) {
+    return std::string();
+  }
 }
 
 }  // namespace factory
@@ -0,0 +1,164 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_CREATION_FRAME_H_
+#define CPP_TOOL_KIT_FACTORY_CREATION_FRAME_H_
+
+#include <cstdint>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// Creation of one object in the current thread, the frames of nested
+/// creations make the chain of objects in progress. Every frame keeps the
+/// set of objects in progress as a bit mask (one bit per hash of the
+/// manager), so the check of every creation is O(1): the chain is walked
+/// only when the bit of the object is already set, that is on a cycle or on
+/// a rare collision of hashes. The mask is full for long chains, so the depth
+/// of the chain is limited: the walk is bounded and a runaway chain (a
+/// creator which gets a new object on every level) stops with the error.
+class CreationFrame {
+ public:
+  /// @brief Number of bits in the mask of objects in progress
+  static const uint32_t kMaskBits = 64;
+
+  /// @brief Max number of objects in progress in the chain
+  static const uint32_t kMaxDepth = 256;
+
+  /// @brief Start creation of the object in the current thread
+  /// @param owner [in] instance manager of the object
+  explicit CreationFrame(const void* owner) noexcept
+      : owner_(owner),
+        parent_(CurrentRef()),
+        mask_((parent_ != nullptr ? parent_->mask_ : 0) | Bit(owner)),
+        depth_(parent_ != nullptr ? parent_->depth_ + 1 : 1) {
+    CurrentRef() = this;
+  };
+
+  ~CreationFrame() noexcept { CurrentRef() = parent_; };
+
+  /// @brief Check if the object is already in progress in the current
+  /// thread (the object depends on itself)
+  /// @return Check result
+  bool IsCycle() const noexcept { return IsInProgress(owner_, parent_); };
+
+  /// @brief Check if the chain is longer than 'kMaxDepth', it is checked
+  /// before the cycle, so the walk of the chain is bounded
+  /// @return Check result
+  bool IsTooDeep() const noexcept { return depth_ > kMaxDepth; };
+
+  /// @brief Check if the object is in progress in the chain of the current
+  /// thread
+  /// @param owner [in] instance manager of the object
+  /// @return Check result
+  static bool IsInProgress(const void* owner) noexcept {
+    return IsInProgress(owner, CurrentRef());
+  };
+
+  /// @brief Get the last frame of the current thread
+  /// @return Pointer to the frame or nullptr
+  static const CreationFrame* Current() noexcept { return CurrentRef(); };
+
+  // Ban RAII operations
+  CreationFrame(const CreationFrame&) = delete;
+  CreationFrame& operator=(const CreationFrame&) = delete;
+
+ private:
+  friend class CreationChainScope;
+
+  static const CreationFrame*& CurrentRef() noexcept {
+    static thread_local const CreationFrame* current = nullptr;
+    return current;
+  };
+
+  static uint64_t Bit(const void* owner) noexcept {
+    // Fibonacci hashing, the high bits depend on all bits of the address
+    const uint64_t hash = static_cast<uint64_t>(
+                              reinterpret_cast<uintptr_t>(owner)) *
+                          UINT64_C(0x9E3779B97F4A7C15);
+    return UINT64_C(1) << (hash >> 58);
+  };
+
+  static bool IsInProgress(const void* owner,
+                           const CreationFrame* frame) noexcept;
+
+ private:
+  const void* owner_;
+  const CreationFrame* parent_;
+  uint64_t mask_;    // bits of all objects of the chain
+  uint32_t depth_;  // number of frames in the chain with this one
+};
+
+/// Continues the chain of creation frames of another thread in the current
+/// one, it is used by the tasks of parallel resolution: the creating thread
+/// waits for the task, so its frames live while the task runs. Without it
+/// a cycle over the task would start a new chain on every hop.
+class CreationChainScope {
+ public:
+  /// @brief Set the chain for the current thread
+  /// @param frame [in] last frame of the creating thread or nullptr
+  explicit CreationChainScope(const CreationFrame* frame) noexcept
+      : previous_(CreationFrame::CurrentRef()) {
+    CreationFrame::CurrentRef() = frame;
+  };
+
+  /// @brief Restore the chain of the current thread
+  ~CreationChainScope() noexcept { CreationFrame::CurrentRef() = previous_; };
+
+  // Ban RAII operations
+  CreationChainScope(const CreationChainScope&) = delete;
+  CreationChainScope& operator=(const CreationChainScope&) = delete;
+
+ private:
+  const CreationFrame* previous_;
+};
+
+// Implementation
+
+inline bool CreationFrame::IsInProgress(const void* owner,
+                                        const CreationFrame* frame) noexcept {
+  if (frame == nullptr || (frame->mask_ & Bit(owner)) == 0) {
+    return false;  // the object is not in the chain for sure
+  }
+
+  for (; frame != nullptr; frame = frame->parent_) {
+    if (frame->owner_ == owner) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_CREATION_FRAME_H_
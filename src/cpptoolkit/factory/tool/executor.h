@@ -0,0 +1,126 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_EXECUTOR_H_
+#define CPP_TOOL_KIT_FACTORY_EXECUTOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace cpptoolkit {
+namespace factory {
+
+/// Runs tasks of parallel resolution of dependencies, implement it over own
+/// thread pool. The executor must outlive the Core. A task never waits for
+/// other tasks: dependencies resolved in parallel inside a task are created
+/// in its thread, so a pool with any number of threads is enough.
+class Executor {
+ public:
+  virtual ~Executor() noexcept = default;
+
+  /// @brief Run the task in the current or in another thread. The task must
+  /// be run exactly once, the creation of the object waits for it
+  /// @param task [in] function of the task
+  /// @param argument [in] argument of the function
+  virtual void Execute(void (*task)(void*), void* argument) noexcept = 0;
+};
+
+namespace engine {
+
+/// @brief Waits until the given number of tasks is finished
+class TaskLatch {
+ public:
+  /// @brief Create latch
+  /// @param count [in] number of tasks
+  explicit TaskLatch(size_t count) noexcept : count_(count){};
+
+  /// @brief Mark one task as finished
+  void CountDown() noexcept;
+
+  /// @brief Wait until all tasks are finished
+  void Wait() noexcept;
+
+  // Ban RAII operations
+  TaskLatch(const TaskLatch&) = delete;
+  TaskLatch& operator=(const TaskLatch&) = delete;
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  size_t count_;
+};
+
+/// @brief Marks the current thread as running a task of the executor for a
+/// scope, the previous mark is restored at the end
+class TaskScope {
+ public:
+  TaskScope() noexcept : previous_(CurrentRef()) { CurrentRef() = true; };
+
+  ~TaskScope() noexcept { CurrentRef() = previous_; };
+
+  /// @brief Check if the current thread runs a task of the executor
+  /// @return Check result
+  static bool IsInTask() noexcept { return CurrentRef(); };
+
+  // Ban RAII operations
+  TaskScope(const TaskScope&) = delete;
+  TaskScope& operator=(const TaskScope&) = delete;
+
+ private:
+  static bool& CurrentRef() noexcept {
+    static thread_local bool current = false;
+    return current;
+  };
+
+ private:
+  bool previous_;
+};
+
+// Implementation
+
+inline void TaskLatch::CountDown() noexcept {
+  // notify under the lock, the latch can be deleted right after 'Wait()'
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (--count_ == 0) {
+    finished_.notify_one();
+  }
+}
+
+inline void TaskLatch::Wait() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this]() { return count_ == 0; });
+}
+
+}  // namespace engine
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_EXECUTOR_H_
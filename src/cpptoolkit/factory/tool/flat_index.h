@@ -0,0 +1,336 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_FLAT_INDEX_H_
+#define CPP_TOOL_KIT_FACTORY_FLAT_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "memory_resource.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Calculate hash of the key for a given object type
+/// @param type_id [in] number of the object type
+/// @param key [in] pointer to the key data
+/// @param key_size [in] size of the key data
+/// @return Hash value
+inline uint64_t HashKey(uint32_t type_id, const char* key,
+                        size_t key_size) noexcept {
+  // FNV-1a with final mix, keys are short
+  uint64_t hash = 14695981039346656037ULL ^ type_id;
+  for (size_t i = 0; i < key_size; ++i) {
+    hash ^= static_cast<uint8_t>(key[i]);
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/// Open addressing hash table (type number, key) -> value.
+/// Slots are stored in one array and keys in one buffer, the control bytes of
+/// 8 slots (a group) are loaded into one 64-bit word and probed at once with
+/// integer operations (SWAR, no SIMD instructions). After 'Freeze()' the
+/// table is compacted and becomes read only, so lookups need neither lock nor
+/// allocation. The memory is taken from the memory resource.
+/// @tparam V type of value, must be cheap to copy (pointer)
+template <typename V>
+class FlatIndex {
+ public:
+  /// @brief Create empty table
+  /// @param resource [in] source of memory
+  FlatIndex(MemoryResource* resource = NewDeleteResource()) noexcept
+      : ctrl_(resource),
+        slots_(resource),
+        keys_(resource),
+        size_(0),
+        frozen_(false){};
+
+  /// @brief Add value to the table
+  /// @param type_id [in] number of the object type
+  /// @param key [in] pointer to the key data
+  /// @param key_size [in] size of the key data
+  /// @param value [in] value
+  /// @return false if the key already exists, the table is frozen or there
+  /// is no memory
+  bool Insert(uint32_t type_id, const char* key, size_t key_size,
+              V value) noexcept;
+
+  /// @brief Find value
+  /// @param type_id [in] number of the object type
+  /// @param key [in] pointer to the key data
+  /// @param key_size [in] size of the key data
+  /// @return Value or V() if the key is not found
+  V Find(uint32_t type_id, const char* key, size_t key_size) const noexcept;
+
+  /// @brief Compact the table and close it for changes
+  void Freeze() noexcept;
+
+  /// @brief Check if the table is closed for changes
+  /// @return Check result
+  bool IsFrozen() const noexcept { return frozen_; };
+
+  /// @brief Number of values in the table
+  /// @return Number of values
+  size_t Size() const noexcept { return size_; };
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    size_t key_offset;  // position of the key in keys_
+    uint32_t key_size;
+    uint32_t type_id;
+    V value;
+  };
+
+  static const size_t kGroupSize = 8;
+  static const uint8_t kEmpty = 0x80;
+  static const uint64_t kLsbs = 0x0101010101010101ULL;
+  static const uint64_t kMsbs = 0x8080808080808080ULL;
+
+  uint64_t LoadGroup(size_t group) const noexcept;
+  bool IsEqual(const Slot& slot, uint64_t hash, uint32_t type_id,
+               const char* key, size_t key_size) const noexcept;
+  void Place(const Slot& slot) noexcept;
+  bool Rehash(size_t group_count) noexcept;
+
+  static uint64_t Match(uint64_t group, uint8_t h2) noexcept;
+  static uint32_t LowestByte(uint64_t mask) noexcept;
+  static size_t GroupCountFor(size_t size) noexcept;
+
+ private:
+  // kEmpty or 7 bits of the hash
+  std::vector<uint8_t, ResourceAllocator<uint8_t>> ctrl_;
+  std::vector<Slot, ResourceAllocator<Slot>> slots_;
+  std::vector<char, ResourceAllocator<char>> keys_;  // all keys, one by one
+  size_t size_;
+  bool frozen_;
+};
+
+// Implementation
+
+template <typename V>
+const size_t FlatIndex<V>::kGroupSize;
+template <typename V>
+const uint8_t FlatIndex<V>::kEmpty;
+template <typename V>
+const uint64_t FlatIndex<V>::kLsbs;
+template <typename V>
+const uint64_t FlatIndex<V>::kMsbs;
+
+template <typename V>
+inline bool FlatIndex<V>::Insert(uint32_t type_id, const char* key,
+                                 size_t key_size, V value) noexcept {
+  if (frozen_) {
+    return false;
+  }
+
+  if (Find(type_id, key, key_size) != V()) {
+    return false;
+  }
+
+  // keep load factor under 7/8
+  if ((size_ + 1) * 8 > slots_.size() * 7 &&
+      !Rehash(GroupCountFor(size_ + 1) * 2)) {
+    return false;
+  }
+
+  // the allocator of the resource throws if there is no memory, the table
+  // stays unchanged
+  try {
+    keys_.insert(keys_.end(), key, key + key_size);
+  } catch (const std::bad_alloc&) {
+    return false;
+  }
+
+  Slot slot;
+  slot.hash = HashKey(type_id, key, key_size);
+  slot.key_offset = keys_.size() - key_size;
+  slot.key_size = static_cast<uint32_t>(key_size);
+  slot.type_id = type_id;
+  slot.value = value;
+
+  Place(slot);
+  ++size_;
+  return true;
+}
+
+template <typename V>
+inline V FlatIndex<V>::Find(uint32_t type_id, const char* key,
+                            size_t key_size) const noexcept {
+  if (size_ == 0) {
+    return V();
+  }
+
+  const uint64_t hash = HashKey(type_id, key, key_size);
+  const uint8_t h2 = static_cast<uint8_t>(hash & 0x7F);
+  const size_t mask = slots_.size() / kGroupSize - 1;
+  size_t group_index = static_cast<size_t>(hash >> 7) & mask;
+
+  for (size_t step = 1;; ++step) {
+    const uint64_t group = LoadGroup(group_index);
+    for (uint64_t match = Match(group, h2); match != 0; match &= match - 1) {
+      const size_t index = group_index * kGroupSize + LowestByte(match);
+      if (ctrl_[index] == h2 &&
+          IsEqual(slots_[index], hash, type_id, key, key_size)) {
+        return slots_[index].value;
+      }
+    }
+
+    if ((group & kMsbs) != 0) {  // the group has empty slot, key is absent
+      return V();
+    }
+
+    group_index = (group_index + step) & mask;
+  }
+}
+
+template <typename V>
+inline void FlatIndex<V>::Freeze() noexcept {
+  const size_t group_count = GroupCountFor(size_);
+  if (size_ > 0 && group_count * kGroupSize != slots_.size()) {
+    Rehash(group_count);  // the table is not compacted if there is no memory
+  }
+
+  try {
+    keys_.shrink_to_fit();
+  } catch (const std::bad_alloc&) {
+  }
+
+  frozen_ = true;
+}
+
+template <typename V>
+inline uint64_t FlatIndex<V>::LoadGroup(size_t group) const noexcept {
+  // one unaligned load, the byte of slot i is the byte i of the word
+  uint64_t value;
+  std::memcpy(&value, &ctrl_[group * kGroupSize], sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+template <typename V>
+inline bool FlatIndex<V>::IsEqual(const Slot& slot, uint64_t hash,
+                                  uint32_t type_id, const char* key,
+                                  size_t key_size) const noexcept {
+  return slot.hash == hash && slot.type_id == type_id &&
+         slot.key_size == key_size &&
+         std::memcmp(keys_.data() + slot.key_offset, key, key_size) == 0;
+}
+
+template <typename V>
+inline void FlatIndex<V>::Place(const Slot& slot) noexcept {
+  const size_t mask = slots_.size() / kGroupSize - 1;
+  size_t group_index = static_cast<size_t>(slot.hash >> 7) & mask;
+
+  for (size_t step = 1;; ++step) {
+    const uint64_t empty = LoadGroup(group_index) & kMsbs;
+    if (empty != 0) {
+      const size_t index = group_index * kGroupSize + LowestByte(empty);
+      ctrl_[index] = static_cast<uint8_t>(slot.hash & 0x7F);
+      slots_[index] = slot;
+      return;
+    }
+
+    group_index = (group_index + step) & mask;
+  }
+}
+
+template <typename V>
+inline bool FlatIndex<V>::Rehash(size_t group_count) noexcept {
+  std::vector<uint8_t, ResourceAllocator<uint8_t>> ctrl(ctrl_.get_allocator());
+  std::vector<Slot, ResourceAllocator<Slot>> slots(slots_.get_allocator());
+  try {
+    ctrl.assign(group_count * kGroupSize, kEmpty);
+    slots.assign(group_count * kGroupSize, Slot());
+  } catch (const std::bad_alloc&) {
+    return false;  // the old table is kept
+  }
+
+  ctrl.swap(ctrl_);
+  slots.swap(slots_);
+
+  for (size_t i = 0; i < ctrl.size(); ++i) {
+    if (ctrl[i] != kEmpty) {
+      Place(slots[i]);
+    }
+  }
+
+  return true;
+}
+
+template <typename V>
+inline uint64_t FlatIndex<V>::Match(uint64_t group, uint8_t h2) noexcept {
+  // zero bytes of 'x' are equal to h2, may contain false positives, so the
+  // caller checks the control byte again
+  const uint64_t x = group ^ (kLsbs * h2);
+  return (x - kLsbs) & ~x & kMsbs;
+}
+
+template <typename V>
+inline uint32_t FlatIndex<V>::LowestByte(uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(mask)) >> 3;
+#else
+  uint32_t index = 0;
+  while ((mask & 0xFF) == 0) {
+    mask >>= 8;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+template <typename V>
+inline size_t FlatIndex<V>::GroupCountFor(size_t size) noexcept {
+  // minimal power of 2 groups with load factor under 7/8
+  size_t group_count = 1;
+  while (group_count * kGroupSize * 7 < size * 8) {
+    group_count *= 2;
+  }
+
+  return group_count;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_FLAT_INDEX_H_
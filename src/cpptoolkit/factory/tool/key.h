@@ -0,0 +1,156 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_KEY_H_
+#define CPP_TOOL_KIT_FACTORY_KEY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace cpptoolkit {
+namespace factory {
+
+namespace engine {
+
+/// @brief Key for objects without key
+static const std::string DEFAULT_KEY = "default";
+
+}  // namespace engine
+
+/// Non owning key of registered object, works like string view and never
+/// allocates. The key can be created from a string, an integer or an enum
+/// value. Integer and enum keys with the same value are equal. String keys
+/// of the form of number keys (9 bytes, the first is zero) are reserved:
+/// they are not registered and nothing is found by them.
+class Key {
+ public:
+  /// @brief Create key from null terminated string
+  /// @param key [in] key value, nullptr gives an empty key
+  Key(const char* key) noexcept
+      : data_(key ? key : ""), size_(key ? std::strlen(key) : 0){};
+
+  /// @brief Create key from string data
+  /// @param key [in] pointer to key data, nullptr gives an empty key
+  /// @param size [in] size of key data
+  Key(const char* key, size_t size) noexcept
+      : data_(key ? key : ""), size_(key ? size : 0){};
+
+  /// @brief Create key from string
+  /// @param key [in] key value, must outlive the key
+  Key(const std::string& key) noexcept
+      : data_(key.data()), size_(key.size()){};
+
+  /// @brief Create key from integer or enum value
+  /// @tparam I type of integer or enum
+  /// @param value [in] key value
+  template <typename I,
+            typename = typename std::enable_if<std::is_integral<I>::value ||
+                                               std::is_enum<I>::value>::type>
+  Key(I value) noexcept : data_(nullptr), size_(kNumberSize) {
+    Encode(static_cast<uint64_t>(static_cast<int64_t>(value)));
+  };
+
+  /// @brief Get pointer to key data
+  /// @return Pointer to key data
+  const char* Data() const noexcept { return data_ ? data_ : number_; };
+
+  /// @brief Get size of key data
+  /// @return Size of key data
+  size_t Size() const noexcept { return size_; };
+
+  /// @brief Check if the key is the default key
+  /// @return Check result
+  bool IsDefault() const noexcept;
+
+  /// @brief Check if the string key has the form of a number key
+  /// @return Check result
+  bool IsReserved() const noexcept { return data_ != nullptr && IsNumber(); };
+
+  /// @brief Human readable key value (for messages)
+  /// @return Key value or empty string if there is no memory for it
+  std::string ToString() const noexcept;
+
+ private:
+  // numbers are stored as zero byte and 8 bytes of the value
+  static const size_t kNumberSize = 9;
+
+  void Encode(uint64_t value) noexcept;
+  bool IsNumber() const noexcept;
+
+ private:
+  const char* data_;  // nullptr for numbers
+  size_t size_;
+  char number_[kNumberSize];
+};
+
+// Implementation
+
+inline bool Key::IsDefault() const noexcept {
+  return size_ == engine::DEFAULT_KEY.size() &&
+         std::memcmp(Data(), engine::DEFAULT_KEY.data(), size_) == 0;
+}
+
+inline std::string Key::ToString() const noexcept {
+  try {
+    if (!IsNumber()) {
+      return std::string(Data(), size_);
+    }
+
+    uint64_t value = 0;
+    const char* data = Data();
+    for (size_t i = 1; i < kNumberSize; ++i) {
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i]))
+               << ((i - 1) * 8);
+    }
+
+    return std::to_string(static_cast<int64_t>(value));
+  } catch (const std::bad_alloc&) {
+    return std::string();  // the key is only for messages
+  }
+}
+
+inline void Key::Encode(uint64_t value) noexcept {
+  number_[0] = '\0';
+  for (size_t i = 1; i < kNumberSize; ++i) {
+    number_[i] = static_cast<char>((value >> ((i - 1) * 8)) & 0xFF);
+  }
+}
+
+inline bool Key::IsNumber() const noexcept {
+  return size_ == kNumberSize && Data()[0] == '\0';
+}
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_KEY_H_
@@ -0,0 +1,214 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_MEMORY_RESOURCE_H_
+#define CPP_TOOL_KIT_FACTORY_MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace cpptoolkit {
+namespace factory {
+
+/// Source of memory for the factory (the same idea as
+/// std::pmr::memory_resource, which is not available in C++11). The resource
+/// must outlive the Core and all objects created by it.
+class MemoryResource {
+ public:
+  virtual ~MemoryResource() noexcept = default;
+
+  /// @brief Allocate memory block
+  /// @param size [in] size of the block in bytes
+  /// @param alignment [in] alignment of the block
+  /// @return Pointer to the block or nullptr if there is no memory
+  virtual void* Allocate(size_t size, size_t alignment) noexcept = 0;
+
+  /// @brief Deallocate memory block
+  /// @param block [in] pointer from 'Allocate()'
+  /// @param size [in] size of the block, the same as for 'Allocate()'
+  /// @param alignment [in] alignment of the block, the same as for
+  /// 'Allocate()'
+  virtual void Deallocate(void* block, size_t size,
+                          size_t alignment) noexcept = 0;
+};
+
+/// @brief Get resource which uses global operators new and delete, it is
+/// used by default
+/// @return Pointer to the resource, the resource is never deleted
+MemoryResource* NewDeleteResource() noexcept;
+
+namespace engine {
+
+/// @brief Resource over global operators new and delete
+class NewDeleteMemoryResource : public MemoryResource {
+ public:
+  void* Allocate(size_t size, size_t /*alignment*/) noexcept override {
+    return ::operator new(size, std::nothrow);
+  };
+
+  void Deallocate(void* block, size_t /*size*/,
+                  size_t /*alignment*/) noexcept override {
+    ::operator delete(block);
+  };
+};
+
+/// @brief STL allocator over MemoryResource
+/// @tparam T type of allocated objects
+template <typename T>
+class ResourceAllocator {
+ public:
+  typedef T value_type;
+
+  /// @brief Create allocator
+  /// @param resource [in] source of memory
+  ResourceAllocator(MemoryResource* resource) noexcept : resource_(resource){};
+
+  template <typename U>
+  ResourceAllocator(const ResourceAllocator<U>& other) noexcept
+      : resource_(other.Resource()){};
+
+  T* allocate(size_t n) {
+    void* block = resource_->Allocate(n * sizeof(T), alignof(T));
+    if (block == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(block);
+  };
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    resource_->Deallocate(ptr, n * sizeof(T), alignof(T));
+  };
+
+  /// @brief Get source of memory
+  /// @return Pointer to the resource
+  MemoryResource* Resource() const noexcept { return resource_; };
+
+ private:
+  MemoryResource* resource_;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ResourceAllocator<T>& lhs,
+                       const ResourceAllocator<U>& rhs) noexcept {
+  return lhs.Resource() == rhs.Resource();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ResourceAllocator<T>& lhs,
+                       const ResourceAllocator<U>& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+/// @brief Object created in the memory of the resource, the memory is
+/// returned to the resource on 'Release()'
+/// @tparam B type of object with virtual method 'Release()'
+template <typename B>
+class ResourceObject : public B {
+ public:
+  /// @brief Create object
+  /// @param resource [in] owner of the memory
+  /// @param ...args [in] arguments for B constructor
+  template <typename... Args>
+  ResourceObject(MemoryResource* resource, Args&&... args) noexcept
+      : B(std::forward<Args>(args)...), resource_(resource){};
+
+  void Release() noexcept override {
+    MemoryResource* resource = resource_;
+    this->~ResourceObject();
+    resource->Deallocate(this, sizeof(ResourceObject), alignof(ResourceObject));
+  };
+
+ private:
+  MemoryResource* resource_;
+};
+
+/// @brief Create object in the memory of the resource
+/// @tparam B type of object with virtual method 'Release()'
+/// @tparam ...Args types of arguments for B
+/// @param resource [in] source of memory
+/// @param ...args [in] arguments for B constructor
+/// @return Pointer to the object (release it by 'Release()') or nullptr if
+/// there is no memory
+template <typename B, typename... Args>
+inline B* MakeResourceObject(MemoryResource* resource,
+                             Args&&... args) noexcept {
+  void* block = resource->Allocate(sizeof(ResourceObject<B>),
+                                   alignof(ResourceObject<B>));
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  return new (block) ResourceObject<B>(resource, std::forward<Args>(args)...);
+}
+
+/// @brief Create object in the memory of the resource
+/// @tparam T type of object
+/// @tparam ...Args types of arguments for T
+/// @param resource [in] source of memory
+/// @param ...args [in] arguments for T constructor
+/// @return Pointer to the object (delete it by 'DeleteInResource()') or
+/// nullptr if there is no memory
+template <typename T, typename... Args>
+inline T* NewInResource(MemoryResource* resource, Args&&... args) noexcept {
+  void* block = resource->Allocate(sizeof(T), alignof(T));
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  return new (block) T(std::forward<Args>(args)...);
+}
+
+/// @brief Destroy object created by 'NewInResource()' and return the memory
+/// to the resource
+/// @tparam T type of object
+/// @param resource [in] source of memory of the object
+/// @param object [in] pointer to the object or nullptr
+template <typename T>
+inline void DeleteInResource(MemoryResource* resource, T* object) noexcept {
+  if (object == nullptr) {
+    return;
+  }
+
+  object->~T();
+  resource->Deallocate(object, sizeof(T), alignof(T));
+}
+
+}  // namespace engine
+
+inline MemoryResource* NewDeleteResource() noexcept {
+  static engine::NewDeleteMemoryResource resource;
+  return &resource;
+}
+
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_MEMORY_RESOURCE_H_
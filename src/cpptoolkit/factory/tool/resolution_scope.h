@@ -0,0 +1,156 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_RESOLUTION_SCOPE_H_
+#define CPP_TOOL_KIT_FACTORY_RESOLUTION_SCOPE_H_
+
+#include "../manager/context/abstract_context.h"
+#include "arena.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Shared context of one resolution, it is kept by the shared context
+/// itself, the scope holds a reference to it while the tree is created
+struct ScopeEntry {
+  const void* owner;  // instance manager which created the context
+  Arena* arena;       // arena of the tree or nullptr
+  AContext* context;
+  ScopeEntry* next;
+};
+
+/// Contexts shared by all consumers in the tree of one top-level 'Get()'.
+/// The scope is opened by the root of the tree and set for the current
+/// thread, objects registered with 'ShareInResolution()' are created at most
+/// once in it. The scope is opened only if the Core has such objects
+class ResolutionScope {
+ public:
+  /// @brief Open the scope, if there is no scope for the current thread
+  /// @param open [in] false to do nothing
+  explicit ResolutionScope(bool open) noexcept
+      : entries_(nullptr), is_open_(open && CurrentRef() == nullptr) {
+    if (is_open_) {
+      CurrentRef() = this;
+    }
+  };
+
+  /// @brief Close the scope and release its references to shared contexts
+  ~ResolutionScope() noexcept;
+
+  /// @brief Get scope of the current thread
+  /// @return Pointer to scope or nullptr
+  static ResolutionScope* Current() noexcept { return CurrentRef(); };
+
+  /// @brief Find the context created by the manager in the same arena
+  /// @param owner [in] instance manager
+  /// @param arena [in] arena of the current tree or nullptr
+  /// @return Context or nullptr if it was not created
+  AContext* Find(const void* owner, const Arena* arena) const noexcept;
+
+  /// @brief Add the shared context, the scope takes one reference of it
+  /// @param entry [in] entry of the context
+  void Add(ScopeEntry* entry) noexcept;
+
+  // Ban RAII operations
+  ResolutionScope(const ResolutionScope&) = delete;
+  ResolutionScope& operator=(const ResolutionScope&) = delete;
+
+ private:
+  friend class SuspendedResolutionScope;
+
+  static ResolutionScope*& CurrentRef() noexcept {
+    static thread_local ResolutionScope* current = nullptr;
+    return current;
+  };
+
+ private:
+  ScopeEntry* entries_;
+  bool is_open_;
+};
+
+/// @brief Suspend the scope of the current thread for a scope, the object
+/// created in it is the root of a new resolution and opens its own scope.
+/// The previous scope is restored at the end
+class SuspendedResolutionScope {
+ public:
+  SuspendedResolutionScope() noexcept
+      : previous_(ResolutionScope::CurrentRef()) {
+    ResolutionScope::CurrentRef() = nullptr;
+  };
+
+  ~SuspendedResolutionScope() noexcept {
+    ResolutionScope::CurrentRef() = previous_;
+  };
+
+  // Ban RAII operations
+  SuspendedResolutionScope(const SuspendedResolutionScope&) = delete;
+  SuspendedResolutionScope& operator=(const SuspendedResolutionScope&) =
+      delete;
+
+ private:
+  ResolutionScope* previous_;
+};
+
+// Implementation
+
+inline ResolutionScope::~ResolutionScope() noexcept {
+  if (!is_open_) {
+    return;
+  }
+
+  CurrentRef() = nullptr;
+  while (entries_ != nullptr) {
+    ScopeEntry* entry = entries_;
+    entries_ = entry->next;  // the entry can be deleted by release
+    entry->context->Release();
+  }
+}
+
+inline AContext* ResolutionScope::Find(const void* owner,
+                                       const Arena* arena) const noexcept {
+  for (ScopeEntry* entry = entries_; entry != nullptr; entry = entry->next) {
+    if (entry->owner == owner && entry->arena == arena) {
+      return entry->context;
+    }
+  }
+
+  return nullptr;
+}
+
+inline void ResolutionScope::Add(ScopeEntry* entry) noexcept {
+  entry->next = entries_;
+  entries_ = entry;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_RESOLUTION_SCOPE_H_
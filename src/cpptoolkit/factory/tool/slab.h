@@ -0,0 +1,253 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_SLAB_H_
+#define CPP_TOOL_KIT_FACTORY_SLAB_H_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "memory_resource.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// Cache of free memory blocks with the same size. The blocks are kept in
+/// a few free lists (shards), a thread uses its own shard, so threads rarely
+/// wait for each other. The slab is created by an owner (instance manager)
+/// and lives until the owner and all allocated blocks are released. The slab
+/// and the blocks are allocated from the memory resource of the owner.
+class Slab {
+ public:
+  /// @brief Default number of cached free blocks
+  static const size_t kDefaultCapacity = 64;
+
+  /// @brief Create slab
+  /// @param block_size [in] size of memory block
+  /// @param resource [in] source of memory
+  /// @return Pointer to slab or nullptr if there is no memory
+  static Slab* Create(size_t block_size,
+                      MemoryResource* resource = NewDeleteResource()) noexcept;
+
+  /// @brief Release the slab by the owner, the slab is deleted after
+  /// the last allocated block is freed
+  /// @param slab [in] pointer to slab or nullptr
+  static void Detach(Slab* slab) noexcept;
+
+  /// @brief Get memory block from the cache or from the heap
+  /// @return Pointer to memory block or nullptr if there is no memory
+  void* Allocate() noexcept;
+
+  /// @brief Put memory block back to the cache or delete it if the cache is
+  /// full
+  /// @param block [in] pointer to memory block from 'Allocate()'
+  void Free(void* block) noexcept;
+
+  /// @brief Set max number of cached free blocks, 0 disables the cache
+  /// @param capacity [in] number of blocks
+  void SetCapacity(size_t capacity) noexcept;
+
+  /// @brief Get max number of cached free blocks
+  /// @return Number of blocks
+  size_t Capacity() const noexcept;
+
+  /// @brief Delete all cached free blocks
+  void Trim() noexcept;
+
+  /// @brief Size of memory block
+  /// @return Size in bytes
+  size_t BlockSize() const noexcept { return block_size_; };
+
+  /// @brief Number of cached free blocks
+  /// @return Number of blocks
+  size_t Size() noexcept;
+
+  // Ban RAII operations
+  Slab(const Slab&) = delete;
+  Slab(Slab&& other) = delete;
+  Slab& operator=(Slab&& other) = delete;
+  Slab& operator=(const Slab&) = delete;
+
+ private:
+  struct Block {
+    Block* next;
+  };
+
+  struct Shard {
+    Shard() noexcept : head(nullptr), size(0){};
+
+    std::mutex mutex;
+    Block* head;
+    size_t size;
+  };
+
+  static const size_t kShardCount = 4;
+
+  static const size_t kAlignment = alignof(std::max_align_t);
+
+  Slab(size_t block_size, MemoryResource* resource) noexcept
+      : block_size_(block_size < sizeof(Block) ? sizeof(Block) : block_size),
+        resource_(resource),
+        shard_capacity_(kDefaultCapacity / kShardCount),
+        references_(1){};
+
+  ~Slab() noexcept { Trim(); };
+
+  void Unref() noexcept;
+  static size_t ShardIndex() noexcept;
+
+ private:
+  const size_t block_size_;
+  MemoryResource* resource_;
+  std::atomic<size_t> shard_capacity_;
+  std::atomic<size_t> references_;  // the owner and allocated blocks
+  Shard shards_[kShardCount];
+};
+
+// Implementation
+
+inline Slab* Slab::Create(size_t block_size,
+                          MemoryResource* resource) noexcept {
+  void* memory = resource->Allocate(sizeof(Slab), alignof(Slab));
+  if (memory == nullptr) {
+    return nullptr;
+  }
+
+  return new (memory) Slab(block_size, resource);
+}
+
+inline void Slab::Detach(Slab* slab) noexcept {
+  if (slab != nullptr) {
+    slab->Unref();
+  }
+}
+
+inline void* Slab::Allocate() noexcept {
+  Shard& shard = shards_[ShardIndex()];
+  Block* block = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    block = shard.head;
+    if (block != nullptr) {
+      shard.head = block->next;
+      --shard.size;
+    }
+  }
+
+  if (block == nullptr) {
+    block = static_cast<Block*>(resource_->Allocate(block_size_, kAlignment));
+    if (block == nullptr) {
+      return nullptr;
+    }
+  }
+
+  references_.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+inline void Slab::Free(void* block) noexcept {
+  Shard& shard = shards_[ShardIndex()];
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.size < shard_capacity_.load(std::memory_order_relaxed)) {
+      Block* free_block = static_cast<Block*>(block);
+      free_block->next = shard.head;
+      shard.head = free_block;
+      ++shard.size;
+      block = nullptr;
+    }
+  }
+
+  if (block != nullptr) {
+    resource_->Deallocate(block, block_size_, kAlignment);
+  }
+
+  Unref();
+}
+
+inline void Slab::SetCapacity(size_t capacity) noexcept {
+  shard_capacity_.store((capacity + kShardCount - 1) / kShardCount,
+                        std::memory_order_relaxed);
+}
+
+inline size_t Slab::Capacity() const noexcept {
+  return shard_capacity_.load(std::memory_order_relaxed) * kShardCount;
+}
+
+inline void Slab::Trim() noexcept {
+  for (Shard& shard : shards_) {
+    Block* block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      block = shard.head;
+      shard.head = nullptr;
+      shard.size = 0;
+    }
+
+    while (block != nullptr) {
+      Block* next = block->next;
+      resource_->Deallocate(block, block_size_, kAlignment);
+      block = next;
+    }
+  }
+}
+
+inline size_t Slab::Size() noexcept {
+  size_t size = 0;
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.size;
+  }
+
+  return size;
+}
+
+inline void Slab::Unref() noexcept {
+  if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    MemoryResource* resource = resource_;
+    this->~Slab();
+    resource->Deallocate(this, sizeof(Slab), alignof(Slab));
+  }
+}
+
+inline size_t Slab::ShardIndex() noexcept {
+  static std::atomic<size_t> counter(0);
+  static thread_local size_t index =
+      counter.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+  return index;
+}
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_SLAB_H_
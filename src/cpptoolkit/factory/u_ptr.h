@@ -30,6 +30,8 @@
 #ifndef CPP_TOOL_KIT_FACTORY_U_PTR_H_
 #define CPP_TOOL_KIT_FACTORY_U_PTR_H_
 
+#include <type_traits>
+
 #include "manager/context/base_context.h"
 #include "manager/context/ptr_holder.h"
 
@@ -44,7 +46,8 @@ class UPtr {
   /// @brief Construct a new UPtr object
   /// @param ptrHolder PtrHolder with Context of managed object
   UPtr(engine::PtrHolder<engine::BaseContext<T>>&& ptrHolder) noexcept
-      : instance_(ptrHolder.Get()->GetInstance()),
+      : instance_(ptrHolder.Get() != nullptr ? ptrHolder.Get()->GetInstance()
+                                              : nullptr),
         context_(std::move(ptrHolder)){};
 
   /// @brief Construct a new UPtr object
@@ -89,10 +92,19 @@ class UPtr {
   ///@return Check result
   bool IsValid() noexcept;
 
-  ///@brief Get description if object was created with error
+  ///@brief Get description if object was created with error, the text is
+  ///built on every call
   ///@return Error description
   std::string Error() const noexcept;
 
+  ///@brief Get reason of the error without building the text
+  ///@return Error code
+  engine::ErrorCode Code() const noexcept;
+
+ private:
+  template <class N>
+  friend class UPtr;
+
  private:
   T* instance_;
   engine::PtrHolder<engine::AContext> context_;
@@ -129,6 +141,16 @@ std::string UPtr<T>::Error() const noexcept {
   return context_->Error();
 }
 
+template <class T>
+engine::ErrorCode UPtr<T>::Code() const noexcept {
+  if (context_.Get() == nullptr) {
+    return engine::ErrorCode::kNotInitialized;  // it is not a success
+  }
+
+  const engine::ErrorInfo* error = context_->GetErrorInfo();
+  return error != nullptr ? error->Code() : engine::ErrorCode::kNone;
+}
+
 template <class T>
 T* UPtr<T>::operator->() const noexcept {
   return instance_;
@@ -0,0 +1,72 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPP_TOOL_KIT_FACTORY_TEST_COUNTING_RESOURCE_H_
+#define CPP_TOOL_KIT_FACTORY_TEST_COUNTING_RESOURCE_H_
+
+#include <cpptoolkit/factory/tool/memory_resource.h>
+
+#include <atomic>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+/// @brief Resource counts allocated memory
+class CountingResource : public MemoryResource {
+ public:
+  CountingResource() noexcept
+      : allocations(0), bytes(0), is_exhausted(false){};
+
+  void* Allocate(size_t size, size_t alignment) noexcept override {
+    if (is_exhausted) {
+      return nullptr;
+    }
+
+    ++allocations;
+    bytes += size;
+    return NewDeleteResource()->Allocate(size, alignment);
+  };
+
+  void Deallocate(void* block, size_t size,
+                  size_t alignment) noexcept override {
+    bytes -= size;
+    NewDeleteResource()->Deallocate(block, size, alignment);
+  };
+
+  std::atomic<size_t> allocations;
+  std::atomic<size_t> bytes;  // not deallocated bytes
+  std::atomic<bool> is_exhausted;  // the resource fails all allocations
+};
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
+
+#endif  // CPP_TOOL_KIT_FACTORY_TEST_COUNTING_RESOURCE_H_
@@ -0,0 +1,201 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+#include "mock/counting_resource.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestArena)
+
+BOOST_AUTO_TEST_CASE(test_arena_allocate) {
+  // arrange
+  CountingResource resource;
+  Arena* arena = Arena::Create(64, &resource);
+
+  // act
+  char* block_1 = static_cast<char*>(arena->Allocate(1, 1));
+  char* block_2 = static_cast<char*>(arena->Allocate(8, 8));
+  size_t used = arena->Used();
+  size_t allocations = resource.allocations;
+  void* block_3 = arena->Allocate(256, 8);  // does not fit, new chunk
+  Arena::Destroy(arena);
+
+  // assert
+  BOOST_CHECK(block_1 + 8 == block_2);
+  BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(block_2) % 8);
+  BOOST_CHECK_EQUAL(16, used);
+  BOOST_CHECK_EQUAL(1, allocations);
+  BOOST_CHECK(block_3 != nullptr);
+  BOOST_CHECK_EQUAL(2, resource.allocations);
+  BOOST_CHECK_EQUAL(0, resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_scope) {
+  // arrange
+  CountingResource resource;
+  Arena* arena = Arena::Create(64, &resource);
+  Arena* inner = nullptr;
+  Arena* suspended = nullptr;
+
+  // act
+  {
+    ArenaScope scope(arena);
+    inner = Arena::Current();
+    {
+      ArenaScope suspend(nullptr);
+      suspended = Arena::Current();
+    }
+  }
+  Arena* outer = Arena::Current();
+  Arena::Destroy(arena);
+
+  // assert
+  BOOST_CHECK_EQUAL(arena, inner);
+  BOOST_CHECK(suspended == nullptr);
+  BOOST_CHECK(outer == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_arena_dependency_tree, Fixture) {
+  // arrange
+  CountingResource resource;
+  Builder builder(&resource);
+  builder.RegisterType<MockUnitLevel_3>();
+  builder.Register<MockUnitLevel_2>([](Resolver& resolver) -> MockUnitLevel_2* {
+    return resolver.Construct<MockUnitLevel_2_A>(
+        resolver.Get<MockUnitLevel_3>());
+  });
+  builder
+      .Register<MockUnitSingleInstance>(
+          [](Resolver& resolver) -> MockUnitSingleInstance* {
+            return Create<MockUnitSingleInstance>(
+                resolver.Get<MockUnitLevel_3>());
+          })
+      .AsSingleInstance();
+  builder
+      .Register<MockUnitLevel_1>(CreateFunction<MockUnitLevel_1>(
+          [](Resolver& resolver) -> MockUnitLevel_1* {
+            resolver.Get<MockUnitSingleInstance>();
+            return resolver.Construct<MockUnitLevel_1>(
+                resolver.Get<MockUnitLevel_2>(),
+                resolver.Get<MockUnitLevel_2>());
+          }))
+      .UseArena();
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  MultipleInstanceManager<MockUnitLevel_1>* manager =
+      static_cast<MultipleInstanceManager<MockUnitLevel_1>*>(
+          core->Find(TypeId<MockUnitLevel_1>()));
+
+  // act
+  UPtr<MockUnitLevel_1> level_1 = core->Get<MockUnitLevel_1>();
+  Context<MockUnitLevel_1>* root =
+      static_cast<Context<MockUnitLevel_1>*>(level_1.context_.Get());
+  bool has_arena =
+      root->ops_ == &ContextTable<ArenaContext<Context<MockUnitLevel_1>>>::kOps &&
+      static_cast<ArenaContext<Context<MockUnitLevel_1>>*>(root)->owned_arena_;
+  bool is_instance_in_arena = root->IsInStorage(root->GetInstance());
+  bool is_single_in_arena = root->dependencies_[0]->Kind() != ContextKind::kWeak;
+  bool is_dependency_in_arena =
+      root->dependencies_[1]->ops_ ==
+      &ContextTable<ArenaContext<Context<MockUnitLevel_2>>>::kOps;
+  size_t arena_size = manager->arena_size_;
+  level_1.Reset();
+
+  // assert
+  BOOST_CHECK(has_arena);
+  BOOST_CHECK(is_instance_in_arena);
+  BOOST_CHECK(!is_single_in_arena);
+  BOOST_CHECK(is_dependency_in_arena);
+  BOOST_CHECK(arena_size > sizeof(ArenaContext<Context<MockUnitLevel_1>>));
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_1::getDestructorCounter());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_2::getDestructorCounter());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getDestructorCounter());  // single
+  BOOST_CHECK_EQUAL(3, MockUnitLevel_3::getConstructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_arena_top_level_get_in_creator, Fixture) {
+  // arrange
+  cf::Core* core_ptr = nullptr;
+  UPtr<MockUnitLevel_3> top_level{
+      PtrHolder<BaseContext<MockUnitLevel_3>>(nullptr)};
+  Arena* top_level_arena = reinterpret_cast<Arena*>(1);
+  Builder builder;
+  builder.RegisterType<MockUnitLevel_3>();
+  builder
+      .Register<MockUnitLevel_3>([&](Resolver& resolver) -> MockUnitLevel_3* {
+        top_level_arena = Arena::Current();
+        return resolver.Construct<MockUnitLevel_3>();
+      })
+      .SetKey("top");
+  builder
+      .Register<MockUnitLevel_2>([&](Resolver& resolver) -> MockUnitLevel_2* {
+        // the object is not a dependency, it outlives the tree
+        top_level = core_ptr->Get<MockUnitLevel_3>("top");
+        return resolver.Construct<MockUnitLevel_2_A>(
+            resolver.Get<MockUnitLevel_3>());
+      })
+      .UseArena();
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  core_ptr = core.get();
+
+  // act
+  UPtr<MockUnitLevel_2> level_2 = core->Get<MockUnitLevel_2>();
+  level_2.Reset();  // the arena of the tree is deleted
+  uintptr_t top_level_ptr = top_level->getMyPtr();
+  top_level.Reset();
+
+  // assert
+  BOOST_CHECK(top_level_arena == nullptr);
+  BOOST_CHECK(top_level_ptr != 0);
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_only_for_multiple_instance) {
+  // arrange
+  Builder builder;
+  builder.RegisterType<MockUnitLevel_3>().AsSingleInstance().UseArena();
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(!core);
+  BOOST_CHECK(builder.Error().find("arena") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -40,9 +40,17 @@ class Mock : public BaseInstanceManager<T> {
  public:
   Mock(const std::string class_name_key,
        std::function<T*(cf::Resolver&)>&& create, cf::Core* core)
-      : BaseInstanceManager<T>(class_name_key, std::move(create), core){};
+      : BaseInstanceManager<T>(class_name_key, core),
+        create_(std::move(create)){};
 
   PtrHolder<BaseContext<T>> Get() noexcept override;
+
+  void Create(Context<T>* context) noexcept {
+    BaseInstanceManager<T>::Create(context, create_);
+  };
+
+ private:
+  std::function<T*(cf::Resolver&)> create_;
 };
 
 template <typename T>
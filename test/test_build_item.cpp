@@ -48,7 +48,7 @@ BOOST_AUTO_TEST_CASE(test_build_item_normal_case) {
 
   // assert
   BOOST_CHECK(result);
-  BOOST_CHECK_EQUAL(1, core.index_.size());
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
 }
 
 BOOST_AUTO_TEST_CASE(test_build_item_set_count_option_single_instance) {
@@ -65,9 +65,8 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_count_option_single_instance) {
 
   // assert
   BOOST_CHECK(result);
-  BOOST_CHECK_EQUAL(1, core.index_.size());
-  for (auto& it : core.index_) {
-    PtrHolder<AInstanceManager>& u_ptr = it.second;
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+  for (PtrHolder<AInstanceManager>& u_ptr : core.managers_) {
     auto manager =
         dynamic_cast<SingleInstanceManager<MockUnitLevel_3>*>(u_ptr.Get());
     BOOST_CHECK(manager != nullptr);
@@ -88,9 +87,8 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_count_option_multiple_instance) {
 
   // assert
   BOOST_CHECK(result);
-  BOOST_CHECK_EQUAL(1, core.index_.size());
-  for (auto& it : core.index_) {
-    PtrHolder<AInstanceManager>& u_ptr = it.second;
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+  for (PtrHolder<AInstanceManager>& u_ptr : core.managers_) {
     auto manager =
         dynamic_cast<MultipleInstanceManager<MockUnitLevel_3>*>(u_ptr.Get());
     BOOST_CHECK(manager != nullptr);
@@ -112,9 +110,8 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_count_option_lock_pool_instance) {
 
   // assert
   BOOST_CHECK(result);
-  BOOST_CHECK_EQUAL(1, core.index_.size());
-  for (auto& it : core.index_) {
-    PtrHolder<AInstanceManager>& u_ptr = it.second;
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+  for (PtrHolder<AInstanceManager>& u_ptr : core.managers_) {
     auto manager =
         dynamic_cast<LockPoolInstanceManager<MockUnitLevel_3>*>(u_ptr.Get());
     BOOST_CHECK(manager != nullptr);
@@ -137,9 +134,8 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_count_option_pool_instance) {
 
   // assert
   BOOST_CHECK(result);
-  BOOST_CHECK_EQUAL(1, core.index_.size());
-  for (auto& it : core.index_) {
-    PtrHolder<AInstanceManager>& u_ptr = it.second;
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+  for (PtrHolder<AInstanceManager>& u_ptr : core.managers_) {
     auto manager =
         dynamic_cast<SoftPoolInstanceManager<MockUnitLevel_3>*>(u_ptr.Get());
     BOOST_CHECK(manager != nullptr);
@@ -163,7 +159,7 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_zero_count_option_lock_pool_instance) {
   // assert
   BOOST_CHECK(!result);
   BOOST_CHECK(!lock_pool_item.Error().empty());
-  BOOST_CHECK_EQUAL(0, core.index_.size());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
 }
 
 BOOST_AUTO_TEST_CASE(test_build_item_set_zero_count_option_pool_instance) {
@@ -182,7 +178,7 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_zero_count_option_pool_instance) {
   // assert
   BOOST_CHECK(!result);
   BOOST_CHECK(!pool_item.Error().empty());
-  BOOST_CHECK_EQUAL(0, core.index_.size());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
 }
 
 BOOST_AUTO_TEST_CASE(test_build_item_set_empty_key) {
@@ -199,7 +195,25 @@ BOOST_AUTO_TEST_CASE(test_build_item_set_empty_key) {
   // assert
   BOOST_CHECK(!result);
   BOOST_CHECK(!item.Error().empty());
-  BOOST_CHECK_EQUAL(0, core.index_.size());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_item_set_null_key) {
+  // arrange
+  CoreExtension core;
+  BuildItem<MockUnitLevel_3> item([](cf::Resolver& resolver) -> MockUnitLevel_3* {
+    return new MockUnitLevel_3();
+  });
+  const char* key = nullptr;
+
+  // act
+  item.SetKey(key);
+  bool result = item.Build(&core);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(!item.Error().empty());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
 }
 
 BOOST_AUTO_TEST_CASE(test_build_item_register_one_type_twice) {
@@ -219,7 +233,66 @@ BOOST_AUTO_TEST_CASE(test_build_item_register_one_type_twice) {
   // assert
   BOOST_CHECK(!result);
   BOOST_CHECK(!item_2.Error().empty());
-  BOOST_CHECK_EQUAL(1, core.index_.size());
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_item_keeps_type_of_creator) {
+  // arrange
+  CoreExtension core;
+  BuildItem<MockUnitLevel_3, TypeCreator<MockUnitLevel_3>> item(
+      (TypeCreator<MockUnitLevel_3>()));
+
+  // act
+  bool result = item.Build(&core);
+  UPtr<MockUnitLevel_3> instance = core.Get<MockUnitLevel_3>();
+
+  // assert
+  BOOST_CHECK(result);
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
+  auto manager = dynamic_cast<
+      MultipleInstanceManager<MockUnitLevel_3, TypeCreator<MockUnitLevel_3>>*>(
+      core.managers_[0].Get());
+  BOOST_CHECK(manager != nullptr);
+  BOOST_CHECK(instance.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_item_no_memory_for_interface) {
+  // arrange
+  typedef TypeCreator<MockUnitLevel_2_A, MockUnitLevel_3> Creator;
+  CoreExtension core;
+  BuildItem<MockUnitLevel_2_A, Creator> item{Creator()};
+  item.is_no_memory_ = true;  // as if 'As()' had no memory for the helper
+
+  // act
+  BuildItem<MockUnitLevel_2, AsCreator<MockUnitLevel_2, Creator>>& detached =
+      DetachedItem<
+          BuildItem<MockUnitLevel_2, AsCreator<MockUnitLevel_2, Creator>>>(
+          AsCreator<MockUnitLevel_2, Creator>{Creator()});
+  detached.SetKey("A").AsSingleInstance();  // the properties are not used
+  bool result = item.Build(&core);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(!item.Error().empty());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_item_as_interface_twice) {
+  // arrange
+  typedef TypeCreator<MockUnitLevel_2_A, MockUnitLevel_3> Creator;
+  CoreExtension core;
+  BuildItem<MockUnitLevel_2_A, Creator> item{Creator()};
+  item.As<MockUnitLevel_2>();
+
+  // act
+  item.As<MockUnitLevel_2>().SetKey("A");  // the creator is already moved
+  bool result = item.Build(&core);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(item.is_as_twice_);
+  BOOST_CHECK(!item.Error().empty());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
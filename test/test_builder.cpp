@@ -32,6 +32,20 @@
 namespace cpptoolkit {
 namespace factory {
 
+namespace {
+
+// the first dependency is not registered in the test
+struct FailingFirst {
+  FailingFirst(engine::MockUnitLevel_2* level_2,
+               engine::MockUnitLevel_3* level_3)
+      : level_2(level_2), level_3(level_3){};
+
+  engine::MockUnitLevel_2* level_2;
+  engine::MockUnitLevel_3* level_3;
+};
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(TestBuilder)
 
 BOOST_AUTO_TEST_CASE(test_builder_normal_case) {
@@ -45,7 +59,8 @@ BOOST_AUTO_TEST_CASE(test_builder_normal_case) {
 
   // assert
   BOOST_CHECK(core);
-  BOOST_CHECK_EQUAL(1, core->index_.size());
+  BOOST_CHECK_EQUAL(1, core->managers_.size());
+  BOOST_CHECK(core->keyed_index_.IsFrozen());
 }
 
 BOOST_AUTO_TEST_CASE(test_builder_clear_all_registered_objects_after_build) {
@@ -92,6 +107,296 @@ BOOST_AUTO_TEST_CASE(test_builder_error_transfer) {
   BOOST_CHECK(!builder.Error().empty());
 }
 
+BOOST_AUTO_TEST_CASE(test_builder_register_with_number_and_enum_keys) {
+  // arrange
+  enum class Kind { kA = 10, kB = 20 };
+  Builder builder;
+  builder
+      .Register<engine::MockUnitLevel_2>(
+          [](Resolver& resolver) -> engine::MockUnitLevel_2* {
+            return Create<engine::MockUnitLevel_2_B>();
+          })
+      .SetKey(Kind::kA);
+  builder
+      .Register<engine::MockUnitLevel_2>(
+          [](Resolver& resolver) -> engine::MockUnitLevel_2* {
+            return Create<engine::MockUnitLevel_2_B>();
+          })
+      .SetKey(5);
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr_1 =
+      core->Get<engine::MockUnitLevel_2>(Kind::kA);
+  UPtr<engine::MockUnitLevel_2> uptr_2 = core->Get<engine::MockUnitLevel_2>(10);
+  UPtr<engine::MockUnitLevel_2> uptr_3 = core->Get<engine::MockUnitLevel_2>(5);
+  UPtr<engine::MockUnitLevel_2> uptr_4 =
+      core->Get<engine::MockUnitLevel_2>(Kind::kB);
+  UPtr<engine::MockUnitLevel_2> uptr_5 = core->Get<engine::MockUnitLevel_2>("5");
+
+  // assert
+  BOOST_CHECK(uptr_1.IsValid());
+  BOOST_CHECK(uptr_2.IsValid());
+  BOOST_CHECK(uptr_3.IsValid());
+  BOOST_CHECK(!uptr_4.IsValid());
+  BOOST_CHECK(uptr_4.Error().find("/20") != std::string::npos);
+  BOOST_CHECK(!uptr_5.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_string_key_of_number_form) {
+  // arrange
+  const Key number(5);
+  const std::string data(number.Data(), number.Size());
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_3>().SetKey(5);
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+  builder.RegisterType<engine::MockUnitLevel_3>().SetKey(data);
+
+  // act
+  UPtr<engine::MockUnitLevel_3> uptr = core->Get<engine::MockUnitLevel_3>(data);
+  std::unique_ptr<Core> core_2 = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(!uptr.IsValid());
+  BOOST_CHECK(!core_2);
+  BOOST_CHECK(!builder.Error().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_register_type_with_dependencies) {
+  // arrange
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_3>();
+  builder
+      .RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .SetKey("A")
+      .As<engine::MockUnitLevel_2>()
+      .AsSingleInstance();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr_1 =
+      core->Get<engine::MockUnitLevel_2>("A");
+  UPtr<engine::MockUnitLevel_2> uptr_2 =
+      core->Get<engine::MockUnitLevel_2>("A");
+  UPtr<engine::MockUnitLevel_2_A> uptr_3 =
+      core->Get<engine::MockUnitLevel_2_A>("A");
+
+  // assert
+  BOOST_CHECK(uptr_1.IsValid());
+  BOOST_CHECK(uptr_1.Get() == uptr_2.Get());  // single instance
+  BOOST_CHECK(!uptr_3.IsValid());  // registered as the interface only
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_bind_dependencies_on_build) {
+  // arrange
+  typedef engine::TypeCreator<engine::MockUnitLevel_2_A,
+                              engine::MockUnitLevel_3>
+      Creator;
+  typedef engine::MultipleInstanceManager<
+      engine::MockUnitLevel_2,
+      engine::AsCreator<engine::MockUnitLevel_2, Creator>>
+      Manager;
+  Builder builder;
+  // the dependency is registered after the object
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  builder.RegisterType<engine::MockUnitLevel_3>();
+
+  // act
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+  UPtr<engine::MockUnitLevel_2> uptr = core->Get<engine::MockUnitLevel_2>();
+
+  // assert
+  Manager* manager = static_cast<Manager*>(core->managers_[0].Get());
+  Handle<engine::MockUnitLevel_3> handle =
+      std::get<0>(manager->create_.create.handles_);
+  BOOST_CHECK(handle.IsValid());
+  BOOST_CHECK(handle.Manager() == core->managers_[1].Get());
+  BOOST_CHECK(uptr.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_plan_of_declared_tree) {
+  // arrange
+  typedef engine::MultipleInstanceManager<
+      engine::MockUnitLevel_1,
+      engine::TypeCreator<engine::MockUnitLevel_1, engine::MockUnitLevel_2,
+                          engine::MockUnitLevel_2>>
+      Manager;
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_1, engine::MockUnitLevel_2,
+                       engine::MockUnitLevel_2>();
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  builder.RegisterType<engine::MockUnitLevel_3>();
+
+  // act
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+  UPtr<engine::MockUnitLevel_1> uptr = core->Get<engine::MockUnitLevel_1>();
+
+  // assert
+  // the plans of dependencies are inlined: 3, 2, 3, 2, 1
+  Manager* manager = static_cast<Manager*>(core->managers_[0].Get());
+  BOOST_CHECK_EQUAL(manager->plan_.size(), 5);
+  BOOST_CHECK(manager->plan_[0].manager == core->managers_[2].Get());
+  BOOST_CHECK(manager->plan_[1].manager == core->managers_[1].Get());
+  BOOST_CHECK_EQUAL(manager->plan_[1].dependency_count, 1);
+  BOOST_CHECK(manager->plan_[4].manager == manager);
+  BOOST_CHECK_EQUAL(manager->plan_[4].dependency_count, 2);
+  for (const engine::PlanStep& step : manager->plan_) {
+    BOOST_CHECK(step.is_planned);
+  }
+
+  BOOST_CHECK(uptr.IsValid());
+  BOOST_CHECK(uptr->unit_ != nullptr);
+  BOOST_CHECK(uptr->unit_2_ != nullptr);
+  BOOST_CHECK(uptr->unit_ != uptr->unit_2_);
+  BOOST_CHECK(
+      static_cast<engine::MockUnitLevel_2_A*>(uptr->unit_)->junior_ !=
+      nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_plan_with_single_instance) {
+  // arrange
+  typedef engine::MultipleInstanceManager<
+      engine::MockUnitLevel_2,
+      engine::AsCreator<engine::MockUnitLevel_2,
+                        engine::TypeCreator<engine::MockUnitLevel_2_A,
+                                            engine::MockUnitLevel_3>>>
+      Manager;
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  builder.RegisterType<engine::MockUnitLevel_3>().AsSingleInstance();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr = core->Get<engine::MockUnitLevel_2>();
+  UPtr<engine::MockUnitLevel_2> uptr_2 = core->Get<engine::MockUnitLevel_2>();
+
+  // assert
+  // the single instance is created by its manager
+  Manager* manager = static_cast<Manager*>(core->managers_[0].Get());
+  BOOST_CHECK_EQUAL(manager->plan_.size(), 2);
+  BOOST_CHECK(!manager->plan_[0].is_planned);
+  BOOST_CHECK(manager->plan_[1].is_planned);
+  BOOST_CHECK(uptr.IsValid());
+  BOOST_CHECK(uptr_2.IsValid());
+  BOOST_CHECK(static_cast<engine::MockUnitLevel_2_A*>(uptr.Get())->junior_ ==
+              static_cast<engine::MockUnitLevel_2_A*>(uptr_2.Get())->junior_);
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_single_instance_outlives_core) {
+  // arrange
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_3>().AsSingleInstance();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+  UPtr<engine::MockUnitLevel_3> uptr = core->Get<engine::MockUnitLevel_3>();
+  BOOST_CHECK(uptr.IsValid());
+
+  // act
+  core.reset();
+  uptr.Reset();  // the context does not touch the deleted manager
+
+  // assert
+  BOOST_CHECK(!uptr.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_no_plan_of_open_tree) {
+  // arrange
+  typedef engine::MultipleInstanceManager<
+      engine::MockUnitLevel_2,
+      engine::AsCreator<engine::MockUnitLevel_2,
+                        engine::TypeCreator<engine::MockUnitLevel_2_A,
+                                            engine::MockUnitLevel_3>>>
+      Manager;
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  // the lambda could get any object on creation
+  builder.Register<engine::MockUnitLevel_3>(
+      [](Resolver&) { return new engine::MockUnitLevel_3(); });
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr = core->Get<engine::MockUnitLevel_2>();
+
+  // assert
+  Manager* manager = static_cast<Manager*>(core->managers_[0].Get());
+  BOOST_CHECK(manager->plan_.empty());
+  BOOST_CHECK(uptr.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_no_plan_with_shared_object) {
+  // arrange
+  typedef engine::MultipleInstanceManager<
+      engine::MockUnitLevel_2,
+      engine::AsCreator<engine::MockUnitLevel_2,
+                        engine::TypeCreator<engine::MockUnitLevel_2_A,
+                                            engine::MockUnitLevel_3>>>
+      Manager;
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  builder.RegisterType<engine::MockUnitLevel_3>().ShareInResolution();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr = core->Get<engine::MockUnitLevel_2>();
+
+  // assert
+  // the shared object needs the resolution scope of the tree
+  Manager* manager = static_cast<Manager*>(core->managers_[0].Get());
+  BOOST_CHECK(manager->plan_.empty());
+  BOOST_CHECK(uptr.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_register_type_without_dependency) {
+  // arrange
+  Builder builder;
+  builder.RegisterType<engine::MockUnitLevel_2_A, engine::MockUnitLevel_3>()
+      .As<engine::MockUnitLevel_2>();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<engine::MockUnitLevel_2> uptr = core->Get<engine::MockUnitLevel_2>();
+
+  // assert
+  BOOST_CHECK(!uptr.IsValid());
+  BOOST_CHECK(uptr.Error().find(typeid(engine::MockUnitLevel_3).name()) !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_builder_register_type_stops_on_first_error) {
+  // arrange
+  Builder builder;
+  builder.RegisterType<FailingFirst, engine::MockUnitLevel_2,
+                       engine::MockUnitLevel_3>();
+  builder.RegisterType<engine::MockUnitLevel_3>();
+  std::unique_ptr<Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+  engine::MockUnitLevel_3::reset();
+
+  // act
+  UPtr<FailingFirst> uptr = core->Get<FailingFirst>();
+
+  // assert
+  // the next dependency is not created for the object which fails anyway
+  BOOST_CHECK(!uptr.IsValid());
+  BOOST_CHECK(uptr.Error().find(typeid(engine::MockUnitLevel_2).name()) !=
+              std::string::npos);
+  BOOST_CHECK_EQUAL(0, engine::MockUnitLevel_3::getConstructorCounter());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace factory
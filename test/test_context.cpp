@@ -91,7 +91,7 @@ BOOST_FIXTURE_TEST_CASE(test_context_add_dependency_normal_case, Fixture) {
   context.Add(std::move(a_context_ptr));
 
   // assert
-  BOOST_CHECK_EQUAL(1, context.dependencies_.size());
+  BOOST_CHECK_EQUAL(1, context.DependencyCount());
 }
 
 BOOST_FIXTURE_TEST_CASE(test_context_check_error_transfer, Fixture) {
@@ -112,7 +112,34 @@ BOOST_FIXTURE_TEST_CASE(test_context_check_error_transfer, Fixture) {
   // assert
   BOOST_CHECK(!valid_ctx.IsValid());
   BOOST_CHECK(!valid_ctx.Error().empty());
-  BOOST_CHECK_EQUAL(1, valid_ctx.dependencies_.size());
+  BOOST_CHECK_EQUAL(1, valid_ctx.DependencyCount());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_context_error_is_shared_with_parent, Fixture) {
+  // arrange
+  PtrHolder<ErrorContext<MockUnitLevel_3>> invalid_ctx =
+      MakePtrHolder<ErrorContext<MockUnitLevel_3>>(
+          ErrorCode::kCreateException, "MockUnitLevel_3", "details");
+  const ErrorInfo* error = invalid_ctx->GetErrorInfo();
+  Context<MockUnitLevel_2_B> parent_ctx;
+  Context<MockUnitLevel_1> root_ctx;
+
+  // act
+  parent_ctx.Add(std::move(invalid_ctx));
+  root_ctx.Add(PtrHolder<AContext>(new WeakContext<MockUnitLevel_3>(nullptr)));
+  root_ctx.Add(PtrHolder<AContext>(new ErrorContext<MockUnitLevel_3>(
+      ErrorCode::kCreateException, "Other", "other")));
+  bool root_valid = root_ctx.IsValid();
+
+  // assert
+  BOOST_CHECK(parent_ctx.GetErrorInfo() == error);
+  BOOST_CHECK(error->Code() == ErrorCode::kCreateException);
+  BOOST_CHECK_EQUAL(
+      "Error on create instance: MockUnitLevel_3 Error: details",
+      parent_ctx.Error());
+  BOOST_CHECK(!root_valid);
+  BOOST_CHECK_EQUAL("Error on create instance: Other Error: other",
+                    root_ctx.Error());
 }
 
 BOOST_FIXTURE_TEST_CASE(test_context_check_clearing_all_dependencies, Fixture) {
@@ -154,7 +181,7 @@ BOOST_FIXTURE_TEST_CASE(test_context_check_clearing_all_dependencies, Fixture) {
 
 BOOST_FIXTURE_TEST_CASE(test_weak_context_create_and_delete, Fixture) {
   // arrange
-  std::unique_ptr<BaseContext<MockUnitLevel_3>> context_ptr_h(
+  PtrHolder<BaseContext<MockUnitLevel_3>> context_ptr_h(
       new Context<MockUnitLevel_3>());
   context_ptr_h->SetInstance(new MockUnitLevel_3());
   BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
@@ -164,7 +191,7 @@ BOOST_FIXTURE_TEST_CASE(test_weak_context_create_and_delete, Fixture) {
   {
     PtrHolder<WeakContext<MockUnitLevel_3>> weak_context_ptr_h =
         MakePtrHolder<WeakContext<MockUnitLevel_3>>(
-            context_ptr_h.get()->GetInstance());
+            context_ptr_h.Get()->GetInstance());
     BOOST_CHECK(weak_context_ptr_h->IsValid());
     BOOST_CHECK(weak_context_ptr_h->Error().empty());
   }
@@ -178,15 +205,44 @@ BOOST_FIXTURE_TEST_CASE(test_weak_context_create_and_delete, Fixture) {
 BOOST_FIXTURE_TEST_CASE(test_pool_context_call_putback, Fixture) {
   // arrange
   Mock mock;
-  Context<MockUnitLevel_3> context;
-  uintptr_t val = 5;
+  PtrHolder<Context<MockUnitLevel_3>> context =
+      MakePtrHolder<Context<MockUnitLevel_3>>();
+  context->SetInstance(new MockUnitLevel_3());
+  PoolContext<MockUnitLevel_3> pool_context(&mock, std::move(context));
 
   // act
-  { PoolContext<MockUnitLevel_3> poolContext(&mock, &context, val); }
+  { PtrHolder<BaseContext<MockUnitLevel_3>> checkout(&pool_context); }
 
   // assert
-  BOOST_CHECK_EQUAL(val, mock.Key());
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(&pool_context), mock.Key());
   BOOST_CHECK_EQUAL(1, mock.CallbackCallCounter());
+  BOOST_CHECK(pool_context.GetInstance() != nullptr);
+  BOOST_CHECK_EQUAL(0, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_context_kind, Fixture) {
+  // arrange
+  Mock mock;
+  Context<MockUnitLevel_3> context;
+  WeakContext<MockUnitLevel_3> weak_context(nullptr);
+  ErrorContext<MockUnitLevel_3> error_context("error");
+  SharedContext<ErrorContext<MockUnitLevel_3>> shared_context("error");
+  PoolContext<MockUnitLevel_3> pool_context(
+      &mock, MakePtrHolder<Context<MockUnitLevel_3>>());
+
+  // act
+  { PtrHolder<AContext> shared(&shared_context); }
+
+  // assert
+  BOOST_CHECK(context.Kind() == ContextKind::kOwning);
+  BOOST_CHECK(weak_context.Kind() == ContextKind::kWeak);
+  BOOST_CHECK(error_context.Kind() == ContextKind::kError);
+  BOOST_CHECK(shared_context.Kind() == ContextKind::kError);
+  BOOST_CHECK(pool_context.Kind() == ContextKind::kPool);
+  BOOST_CHECK(context.IsValid());
+  BOOST_CHECK(!error_context.IsValid());
+  BOOST_CHECK(!shared_context.IsValid());  // not deleted by the holder
+  BOOST_CHECK_EQUAL(0, mock.CallbackCallCounter());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -82,6 +82,28 @@ BOOST_FIXTURE_TEST_CASE(test_core_extension_add_manager_twice, Fixture) {
   BOOST_CHECK(!core.LastError().empty());
 }
 
+BOOST_FIXTURE_TEST_CASE(test_core_extension_add_manager_after_freeze,
+                        Fixture) {
+  // arrange
+  CoreExtension core;
+  PtrHolder<MultipleInstanceManager<MockUnitLevel_3>> manager =
+      MakePtrHolder<MultipleInstanceManager<MockUnitLevel_3>>(
+          "MockUnitLevel_3",
+          [](cf::Resolver& resolver) -> MockUnitLevel_3* {
+            return new MockUnitLevel_3();
+          },
+          &core);
+  core.Freeze();
+
+  // act
+  bool result = core.Add(std::move(manager));
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(!core.LastError().empty());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
+}
+
 BOOST_FIXTURE_TEST_CASE(test_core_get_instance_normal_case, Fixture) {
   // arrange and act
   PtrHolder<BaseContext<MockUnitLevel_1>> ptr_holder =
@@ -96,7 +118,7 @@ BOOST_FIXTURE_TEST_CASE(test_core_check_add_manager_to_manager_index, Fixture) {
   // arrange
   std::string error;
   CoreExtension core;
-  BOOST_CHECK_EQUAL(0, core.index_.size());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
   PtrHolder<MultipleInstanceManager<MockUnitLevel_3>> manager =
       MakePtrHolder<MultipleInstanceManager<MockUnitLevel_3>>(
           DEFAULT_KEY,
@@ -112,7 +134,7 @@ BOOST_FIXTURE_TEST_CASE(test_core_check_add_manager_to_manager_index, Fixture) {
   // assert
   BOOST_CHECK(operation_result);
   BOOST_CHECK(error.empty());
-  BOOST_CHECK_EQUAL(1, core.index_.size());
+  BOOST_CHECK_EQUAL(1, core.managers_.size());
 }
 
 BOOST_FIXTURE_TEST_CASE(test_core_try_to_register_type_twice, Fixture) {
@@ -227,6 +249,139 @@ BOOST_FIXTURE_TEST_CASE(test_core_check_transit_error_object, Fixture) {
   BOOST_CHECK(uptr_4.Error().empty());
 }
 
+BOOST_AUTO_TEST_CASE(test_type_id_unique_for_each_type) {
+  // arrange and act
+  uint32_t id_1 = TypeId<MockUnitLevel_1>();
+  uint32_t id_2 = TypeId<MockUnitLevel_2>();
+
+  // assert
+  BOOST_CHECK(id_1 != id_2);
+  BOOST_CHECK_EQUAL(id_1, TypeId<MockUnitLevel_1>());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_find_manager_by_type_id, Fixture) {
+  // arrange and act
+  AInstanceManager* manager = core_->Find(TypeId<MockUnitLevel_3>());
+  AInstanceManager* manager_2 =
+      core_->Find(TypeId<MockUnitLevel_3>(), DEFAULT_KEY);
+  AInstanceManager* keyed_manager = core_->Find(TypeId<MockUnitLevel_2>(), "A");
+  AInstanceManager* not_registered = core_->Find(TypeId<MockUnitLevel_2>());
+
+  // assert
+  BOOST_CHECK(manager != nullptr);
+  BOOST_CHECK_EQUAL(manager, manager_2);
+  BOOST_CHECK(keyed_manager != nullptr);
+  BOOST_CHECK_EQUAL("A", keyed_manager->Key());
+  BOOST_CHECK(not_registered == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_get_instance_with_key, Fixture) {
+  // arrange and act
+  UPtr<MockUnitLevel_2> uptr_1 = core_->Get<MockUnitLevel_2>("A");
+  UPtr<MockUnitLevel_2> uptr_2 = core_->Get<MockUnitLevel_2>("C");
+
+  // assert
+  BOOST_CHECK(uptr_1.IsValid());
+  BOOST_CHECK(!uptr_2.IsValid());
+  BOOST_CHECK(!uptr_2.Error().empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_not_registered_error_is_shared, Fixture) {
+  // arrange and act
+  UPtr<MockUnitNotRegistered> uptr_1 = core_->Get<MockUnitNotRegistered>();
+  UPtr<MockUnitNotRegistered> uptr_2 = core_->Get<MockUnitNotRegistered>();
+  UPtr<MockUnitLevel_2> uptr_3 = core_->Get<MockUnitLevel_2>("C");
+  UPtr<MockUnitLevel_2> uptr_4 = core_->Get<MockUnitLevel_2>("D");
+
+  // assert
+  BOOST_CHECK(!uptr_1.IsValid());
+  BOOST_CHECK(!uptr_3.IsValid());
+  BOOST_CHECK_EQUAL(uptr_1.context_.Get(), uptr_2.context_.Get());
+  BOOST_CHECK(uptr_3.context_.Get() != uptr_4.context_.Get());
+  BOOST_CHECK_EQUAL(uptr_1.Error(), uptr_2.Error());
+  BOOST_CHECK(uptr_4.Error().find("/D") != std::string::npos);
+  BOOST_CHECK_EQUAL(3, core_->miss_contexts_.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_contains, Fixture) {
+  // arrange and act
+  bool registered = core_->Contains<MockUnitLevel_3>();
+  bool registered_with_key = core_->Contains<MockUnitLevel_2>("A");
+  bool not_registered = core_->Contains<MockUnitNotRegistered>();
+  bool not_registered_with_key = core_->Contains<MockUnitLevel_2>("C");
+
+  // assert
+  BOOST_CHECK(registered);
+  BOOST_CHECK(registered_with_key);
+  BOOST_CHECK(!not_registered);
+  BOOST_CHECK(!not_registered_with_key);
+  BOOST_CHECK_EQUAL(0, core_->miss_contexts_.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_try_get, Fixture) {
+  // arrange and act
+  UPtr<MockUnitLevel_2> uptr = core_->TryGet<MockUnitLevel_2>("A");
+  UPtr<MockUnitNotRegistered> empty = core_->TryGet<MockUnitNotRegistered>();
+
+  // assert
+  BOOST_CHECK(uptr.IsValid());
+  BOOST_CHECK(!empty.IsValid());
+  BOOST_CHECK(empty.Get() == nullptr);
+  BOOST_CHECK(empty.context_.Get() == nullptr);
+  BOOST_CHECK(empty.Code() == ErrorCode::kNotInitialized);
+  BOOST_CHECK(uptr.Code() == ErrorCode::kNone);
+  BOOST_CHECK_EQUAL(0, core_->miss_contexts_.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_error_code, Fixture) {
+  // arrange and act
+  UPtr<MockUnitLevel_3> valid = core_->Get<MockUnitLevel_3>();
+  UPtr<MockUnitNotRegistered> not_registered =
+      core_->Get<MockUnitNotRegistered>();
+  UPtr<MockUnitReturnNullOncreate> null_instance =
+      core_->Get<MockUnitReturnNullOncreate>();
+  UPtr<MockUnitThrowExceptionOncreate> exception =
+      core_->Get<MockUnitThrowExceptionOncreate>();
+  UPtr<MockUnitThrowStrOncreate> unknown_exception =
+      core_->Get<MockUnitThrowStrOncreate>();
+
+  // assert
+  BOOST_CHECK(valid.Code() == ErrorCode::kNone);
+  BOOST_CHECK(not_registered.Code() == ErrorCode::kNotRegistered);
+  BOOST_CHECK(null_instance.Code() == ErrorCode::kCreateReturnedNull);
+  BOOST_CHECK(exception.Code() == ErrorCode::kCreateException);
+  BOOST_CHECK(unknown_exception.Code() ==
+              ErrorCode::kCreateUnknownException);
+  BOOST_CHECK(exception.Error().find("Exception created on operation") !=
+              std::string::npos);
+  BOOST_CHECK(null_instance.Error().find("'Create' returned nullptr") !=
+              std::string::npos);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_core_error_outlives_core, Fixture) {
+  // arrange
+  UPtr<MockUnitNotRegistered> not_registered =
+      core_->Get<MockUnitNotRegistered>();
+  UPtr<MockUnitReturnNullOncreate> null_instance =
+      core_->Get<MockUnitReturnNullOncreate>();
+  UPtr<MockUnitThrowExceptionOncreate> exception =
+      core_->Get<MockUnitThrowExceptionOncreate>();
+  const std::string not_registered_error = not_registered.Error();
+  const std::string null_instance_error = null_instance.Error();
+  const std::string exception_error = exception.Error();
+
+  // act
+  core_u_ptr_.reset();
+  core_ = nullptr;
+
+  // assert
+  BOOST_CHECK(not_registered.Code() == ErrorCode::kNotRegistered);
+  BOOST_CHECK_EQUAL(not_registered_error, not_registered.Error());
+  BOOST_CHECK(null_instance.Code() == ErrorCode::kCreateReturnedNull);
+  BOOST_CHECK_EQUAL(null_instance_error, null_instance.Error());
+  BOOST_CHECK_EQUAL(exception_error, exception.Error());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace engine
@@ -0,0 +1,282 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+#include <vector>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+namespace {
+
+struct CycleB;
+
+struct CycleA {
+  explicit CycleA(CycleB* b) : b(b){};
+  CycleB* b;
+};
+
+struct CycleB {
+  explicit CycleB(CycleA* a) : a(a){};
+  CycleA* a;
+};
+
+// A and B depend on each other over lambdas, the cycle is not visible on
+// build
+std::unique_ptr<cf::Core> BuildLambdaCycle(InstanceCountOptionEnum option) {
+  cf::Builder builder;
+  auto& a = builder.Register<CycleA>([](cf::Resolver& resolver) -> CycleA* {
+    return new CycleA(resolver.Get<CycleB>());
+  });
+  builder.Register<CycleB>([](cf::Resolver& resolver) -> CycleB* {
+    return new CycleB(resolver.Get<CycleA>());
+  });
+  if (option == InstanceCountOptionEnum::kSingle) {
+    a.AsSingleInstance();
+  } else if (option == InstanceCountOptionEnum::kLockPool) {
+    a.AsLockPoolInstance(1);
+  }
+
+  return builder.BuildUnique();
+}
+
+// every node of the chain gets the next one by the integer key, the chain
+// has no cycle
+struct ChainNode {
+  explicit ChainNode(ChainNode* next) : next(next){};
+  ChainNode* next;
+};
+
+std::unique_ptr<cf::Core> BuildChain(int length) {
+  cf::Builder builder;
+  for (int i = 0; i < length; ++i) {
+    builder
+        .Register<ChainNode>([i, length](cf::Resolver& resolver) -> ChainNode* {
+          return new ChainNode(i + 1 < length ? resolver.Get<ChainNode>(i + 1)
+                                              : nullptr);
+        })
+        .SetKey(i);
+  }
+
+  return builder.BuildUnique();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestCreationFrame)
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_deep_chain) {
+  // arrange
+  std::vector<int> owners(100);
+  std::vector<std::unique_ptr<CreationFrame>> frames;
+
+  // act
+  for (int& owner : owners) {
+    frames.emplace_back(new CreationFrame(&owner));
+  }
+  bool is_cycle = frames.back()->IsCycle();
+  bool is_repeated_cycle = false;
+  {
+    CreationFrame repeated(&owners[0]);
+    is_repeated_cycle = repeated.IsCycle();
+  }
+  while (!frames.empty()) {
+    frames.pop_back();  // the frames are closed in reverse order
+  }
+
+  // assert
+  BOOST_CHECK(!is_cycle);  // deep, but every object once
+  BOOST_CHECK(is_repeated_cycle);
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_max_depth) {
+  // arrange
+  std::vector<int> owners(CreationFrame::kMaxDepth + 1);
+  std::vector<std::unique_ptr<CreationFrame>> frames;
+
+  // act
+  for (int& owner : owners) {
+    frames.emplace_back(new CreationFrame(&owner));
+  }
+  bool is_last_allowed_too_deep = frames[frames.size() - 2]->IsTooDeep();
+  bool is_too_deep = frames.back()->IsTooDeep();
+  while (!frames.empty()) {
+    frames.pop_back();
+  }
+
+  // assert
+  BOOST_CHECK(!is_last_allowed_too_deep);
+  BOOST_CHECK(is_too_deep);
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_runaway_chain) {
+  // arrange
+  const int length = static_cast<int>(CreationFrame::kMaxDepth) + 10;
+  std::unique_ptr<cf::Core> core = BuildChain(length);
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<ChainNode> too_deep = core->Get<ChainNode>(0);
+  UPtr<ChainNode> allowed = core->Get<ChainNode>(length - 100);
+
+  // assert
+  BOOST_CHECK(!too_deep.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kTooDeep),
+                    static_cast<int>(too_deep.Code()));
+  BOOST_CHECK(allowed.IsValid());
+  BOOST_CHECK(CreationFrame::CurrentRef() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_cycle_found_on_repeat) {
+  // arrange
+  int owner = 0;
+  int other = 0;
+
+  // act
+  CreationFrame frame(&owner);
+  CreationFrame nested(&other);
+  CreationFrame repeated(&owner);
+
+  // assert
+  BOOST_CHECK(!frame.IsCycle());
+  BOOST_CHECK(!nested.IsCycle());
+  BOOST_CHECK(repeated.IsCycle());  // found on the first repeat
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_collision_is_not_cycle) {
+  // arrange
+  // more owners than bits, so two of them have the same bit
+  std::vector<int> owners(CreationFrame::kMaskBits + 1);
+  const int* first = nullptr;
+  const int* second = nullptr;
+  for (size_t i = 0; i < owners.size() && second == nullptr; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (CreationFrame::Bit(&owners[i]) == CreationFrame::Bit(&owners[j])) {
+        first = &owners[j];
+        second = &owners[i];
+        break;
+      }
+    }
+  }
+  BOOST_REQUIRE(second != nullptr);
+
+  // act
+  CreationFrame frame(first);
+  CreationFrame nested(second);
+
+  // assert
+  BOOST_CHECK(frame.mask_ == nested.mask_);
+  BOOST_CHECK(!nested.IsCycle());
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_multiple_instance_cycle) {
+  // arrange
+  std::unique_ptr<cf::Core> core =
+      BuildLambdaCycle(InstanceCountOptionEnum::kMultiple);
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<CycleA> a = core->Get<CycleA>();
+
+  // assert
+  BOOST_CHECK(!a.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kCyclicDependency),
+                    static_cast<int>(a.Code()));
+  BOOST_CHECK(CreationFrame::CurrentRef() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_single_instance_cycle) {
+  // arrange
+  std::unique_ptr<cf::Core> core =
+      BuildLambdaCycle(InstanceCountOptionEnum::kSingle);
+
+  // act
+  UPtr<CycleA> a = core->Get<CycleA>();  // does not deadlock
+
+  // assert
+  BOOST_CHECK(!a.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kCyclicDependency),
+                    static_cast<int>(a.Code()));
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_lock_pool_cycle) {
+  // arrange
+  std::unique_ptr<cf::Core> core =
+      BuildLambdaCycle(InstanceCountOptionEnum::kLockPool);
+
+  // act
+  UPtr<CycleA> a = core->Get<CycleA>();  // does not deadlock
+
+  // assert
+  BOOST_CHECK(!a.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kCyclicDependency),
+                    static_cast<int>(a.Code()));
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_declared_cycle_on_build) {
+  // arrange
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>();
+  builder.RegisterType<CycleA, CycleB>();
+  builder.RegisterType<CycleB, CycleA>();
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(!core);
+  BOOST_CHECK(builder.Error().find("Cyclic dependency") != std::string::npos);
+  BOOST_CHECK(builder.Error().find(typeid(CycleA).name()) !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_creation_frame_declared_acyclic_on_build) {
+  // arrange
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_1, MockUnitLevel_2, MockUnitLevel_2>();
+  builder.RegisterType<MockUnitLevel_2_A, MockUnitLevel_3>()
+      .As<MockUnitLevel_2>();
+  builder.RegisterType<MockUnitLevel_3>();
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(core);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
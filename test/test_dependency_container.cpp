@@ -0,0 +1,150 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/manager/context/weak_context.h>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestDependencyContainer)
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_empty) {
+  // arrange
+  Context<int> context;
+
+  // act
+  bool has_dependencies = context.dependencies_ != nullptr;
+
+  // assert
+  BOOST_CHECK(!has_dependencies);
+  BOOST_CHECK(context.IsValid());
+  BOOST_CHECK_EQUAL(0, context.DependencyCount());
+  BOOST_CHECK(sizeof(Context<int>) <= 8 * sizeof(void*));
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_grow) {
+  // arrange
+  int values[5] = {0, 1, 2, 3, 4};
+  Context<int> context;
+
+  // act
+  for (int i = 0; i < 5; ++i) {
+    context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(values + i)));
+  }
+
+  // assert
+  BOOST_CHECK(context.IsValid());
+  BOOST_CHECK_EQUAL(5, context.DependencyCount());
+  BOOST_CHECK_EQUAL(1, static_cast<int>(context.owns_dependencies_));
+  for (int i = 0; i < 5; ++i) {
+    BOOST_CHECK(static_cast<WeakContext<int>*>(context.dependencies_[i].Get())
+                    ->GetInstance() == values + i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_reserve_in_storage) {
+  // arrange
+  int value = 0;
+  alignas(std::max_align_t) char storage[64];
+  Context<int> context;
+  context.SetStorage(storage, sizeof(storage));
+
+  // act
+  context.ReserveDependencies(2);
+  context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(&value)));
+  context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(&value)));
+
+  // assert
+  BOOST_CHECK_EQUAL(2, context.DependencyCount());
+  BOOST_CHECK_EQUAL(0, static_cast<int>(context.owns_dependencies_));
+  BOOST_CHECK(reinterpret_cast<char*>(context.dependencies_) ==
+              storage + sizeof(storage) - 2 * sizeof(PtrHolder<AContext>));
+  BOOST_CHECK_EQUAL(sizeof(storage) - 2 * sizeof(PtrHolder<AContext>),
+                    context.storage_size_);
+  BOOST_CHECK_EQUAL(0, context.RequiredStorage());
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_required_storage) {
+  // arrange
+  int value = 0;
+  Context<int> context;
+
+  // act
+  context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(&value)));
+  void* storage = context.Storage(12, alignof(int));
+
+  // assert
+  BOOST_CHECK(storage == nullptr);
+  BOOST_CHECK_EQUAL(16 + sizeof(PtrHolder<AContext>),
+                    context.RequiredStorage());
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_ignores_thread_arena) {
+  // arrange
+  int value = 0;
+  Arena* arena = Arena::Create(Arena::kDefaultSize, NewDeleteResource());
+  Context<int> context;
+
+  // act
+  {
+    ArenaScope arena_scope(arena);  // the context is not a part of the tree
+    context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(&value)));
+  }
+
+  // assert
+  BOOST_CHECK_EQUAL(1, static_cast<int>(context.owns_dependencies_));
+  BOOST_CHECK_EQUAL(0, arena->Used());
+  Arena::Destroy(arena);
+}
+
+BOOST_AUTO_TEST_CASE(test_dependency_container_own_arena) {
+  // arrange
+  int value = 0;
+  Arena* arena = Arena::Create(Arena::kDefaultSize, NewDeleteResource());
+  {
+    Context<int> context(arena);
+
+    // act
+    context.Add(PtrHolder<WeakContext<int>>(new WeakContext<int>(&value)));
+
+    // assert
+    BOOST_CHECK_EQUAL(0, static_cast<int>(context.owns_dependencies_));
+    BOOST_CHECK(arena->Used() >= sizeof(PtrHolder<AContext>));
+  }
+  Arena::Destroy(arena);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
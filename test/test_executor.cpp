@@ -0,0 +1,358 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+namespace {
+
+// runs every task in a new thread
+class ThreadExecutor : public Executor {
+ public:
+  ~ThreadExecutor() noexcept {
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  };
+
+  void Execute(void (*task)(void*), void* argument) noexcept override {
+    threads_.emplace_back(task, argument);
+  };
+
+  std::vector<std::thread> threads_;
+};
+
+// runs tasks one after another in one thread
+class OneThreadExecutor : public Executor {
+ public:
+  OneThreadExecutor() : is_stopped_(false), thread_([this]() { Work(); }){};
+
+  ~OneThreadExecutor() noexcept {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopped_ = true;
+    }
+    has_task_.notify_one();
+    thread_.join();
+  };
+
+  void Execute(void (*task)(void*), void* argument) noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace_back(task, argument);
+    has_task_.notify_one();
+  };
+
+ private:
+  void Work() {
+    for (;;) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      has_task_.wait(lock, [this]() { return is_stopped_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+
+      std::pair<void (*)(void*), void*> task = tasks_.front();
+      tasks_.pop_front();
+      lock.unlock();
+      task.first(task.second);
+    }
+  };
+
+  std::mutex mutex_;
+  std::condition_variable has_task_;
+  std::deque<std::pair<void (*)(void*), void*>> tasks_;
+  bool is_stopped_;
+  std::thread thread_;
+};
+
+// runs every task in the calling thread
+class InlineExecutor : public Executor {
+ public:
+  void Execute(void (*task)(void*), void* argument) noexcept override {
+    task(argument);
+  };
+};
+
+// counts instances, it is created in several threads at once
+struct ParallelLeaf {
+  ParallelLeaf() { ++constructor_counter; };
+
+  static std::atomic<int32_t> constructor_counter;
+};
+
+std::atomic<int32_t> ParallelLeaf::constructor_counter(0);
+
+// depends on the leaf, it is created in several threads at once
+struct ParallelNode {
+  explicit ParallelNode(ParallelLeaf* leaf) : leaf(leaf){};
+
+  ParallelLeaf* leaf;
+};
+
+struct Pair {
+  Pair(ParallelLeaf* leaf, ParallelNode* node) : leaf(leaf), node(node){};
+
+  ParallelLeaf* leaf;
+  ParallelNode* node;
+};
+
+// depends on the pair which is created in parallel too
+struct NestedPair {
+  NestedPair(Pair* pair, ParallelLeaf* leaf) : pair(pair), leaf(leaf){};
+
+  Pair* pair;
+  ParallelLeaf* leaf;
+};
+
+// both dependencies are shared in resolution
+struct SharedPair {
+  SharedPair(ParallelLeaf* first, ParallelLeaf* second)
+      : first(first), second(second){};
+
+  ParallelLeaf* first;
+  ParallelLeaf* second;
+};
+
+// the pair with dependencies in parallel, they are shared in resolution
+std::unique_ptr<cf::Core> BuildSharedPair(Executor* executor) {
+  cf::Builder builder;
+  builder.RegisterType<ParallelLeaf>().ShareInResolution();
+  builder.RegisterType<SharedPair, ParallelLeaf, ParallelLeaf>()
+      .ResolveInParallel(executor);
+  return builder.BuildUnique();
+}
+
+struct ParallelCycleB;
+
+// depends on B (over lambda) and on the leaf in parallel
+struct ParallelCycleA {
+  ParallelCycleA(ParallelCycleB* b, ParallelLeaf* leaf) : b(b), leaf(leaf){};
+
+  ParallelCycleB* b;
+  ParallelLeaf* leaf;
+};
+
+struct ParallelCycleB {
+  explicit ParallelCycleB(ParallelCycleA* a) : a(a){};
+
+  ParallelCycleA* a;
+};
+
+// B depends on A over lambda, the cycle is not visible on build
+std::unique_ptr<cf::Core> BuildParallelCycle(Executor* executor,
+                                             bool single) {
+  cf::Builder builder;
+  builder.RegisterType<ParallelLeaf>();
+  auto& a =
+      builder.RegisterType<ParallelCycleA, ParallelCycleB, ParallelLeaf>();
+  a.ResolveInParallel(executor);
+  if (single) {
+    a.AsSingleInstance();
+  }
+
+  builder.Register<ParallelCycleB>(
+      [](cf::Resolver& resolver) -> ParallelCycleB* {
+        return new ParallelCycleB(resolver.Get<ParallelCycleA>());
+      });
+  return builder.BuildUnique();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestExecutor)
+
+BOOST_AUTO_TEST_CASE(test_executor_task_latch) {
+  // arrange
+  TaskLatch latch(2);
+  std::thread thread([&latch]() { latch.CountDown(); });
+
+  // act
+  latch.CountDown();
+  latch.Wait();
+  thread.join();
+
+  // assert
+  BOOST_CHECK_EQUAL(0, latch.count_);
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_resolve_in_parallel) {
+  // arrange
+  ThreadExecutor executor;
+  cf::Builder builder;
+  builder.RegisterType<ParallelLeaf>();
+  builder.RegisterType<ParallelNode, ParallelLeaf>();
+  builder.RegisterType<Pair, ParallelLeaf, ParallelNode>()
+      .ResolveInParallel(&executor);
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<Pair> pair = core->Get<Pair>();
+
+  // assert
+  BOOST_CHECK(pair.IsValid());
+  BOOST_CHECK(pair->leaf != nullptr);
+  BOOST_CHECK(pair->node != nullptr);
+  BOOST_CHECK_EQUAL(1, executor.threads_.size());  // the last in this thread
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_nested_in_one_thread) {
+  // arrange
+  OneThreadExecutor executor;
+  cf::Builder builder;
+  builder.RegisterType<ParallelLeaf>();
+  builder.RegisterType<ParallelNode, ParallelLeaf>();
+  builder.RegisterType<Pair, ParallelLeaf, ParallelNode>()
+      .ResolveInParallel(&executor);
+  builder.RegisterType<NestedPair, Pair, ParallelLeaf>()
+      .ResolveInParallel(&executor);
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  // the pair is created in the only thread of the executor, its
+  // dependencies can not wait for another thread
+  UPtr<NestedPair> nested = core->Get<NestedPair>();
+
+  // assert
+  BOOST_CHECK(nested.IsValid());
+  BOOST_CHECK(nested->pair->leaf != nullptr);
+  BOOST_CHECK(nested->pair->node != nullptr);
+  BOOST_CHECK(nested->leaf != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_shared_in_resolution) {
+  // arrange
+  ThreadExecutor thread_executor;
+  InlineExecutor inline_executor;
+  std::unique_ptr<cf::Core> thread_core = BuildSharedPair(&thread_executor);
+  std::unique_ptr<cf::Core> inline_core = BuildSharedPair(&inline_executor);
+  BOOST_CHECK(thread_core);
+  BOOST_CHECK(inline_core);
+  ParallelLeaf::constructor_counter = 0;
+
+  // act
+  // each dependency is the root of its own resolution, in every thread
+  UPtr<SharedPair> thread_pair = thread_core->Get<SharedPair>();
+  UPtr<SharedPair> inline_pair = inline_core->Get<SharedPair>();
+
+  // assert
+  BOOST_CHECK(thread_pair.IsValid());
+  BOOST_CHECK(inline_pair.IsValid());
+  BOOST_CHECK(thread_pair->first != thread_pair->second);
+  BOOST_CHECK(inline_pair->first != inline_pair->second);
+  BOOST_CHECK_EQUAL(4, ParallelLeaf::constructor_counter.load());
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_error_of_first_dependency) {
+  // arrange
+  ThreadExecutor executor;
+  cf::Builder builder;
+  builder.RegisterType<Pair, ParallelLeaf, ParallelNode>()
+      .ResolveInParallel(&executor);
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<Pair> pair = core->Get<Pair>();
+
+  // assert
+  BOOST_CHECK(!pair.IsValid());
+  BOOST_CHECK(pair.Error().find(typeid(ParallelLeaf).name()) !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_cycle_over_task) {
+  // arrange
+  ThreadExecutor executor;
+  std::unique_ptr<cf::Core> core = BuildParallelCycle(&executor, false);
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<ParallelCycleA> a = core->Get<ParallelCycleA>();
+
+  // assert
+  BOOST_CHECK(!a.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kCyclicDependency),
+                    static_cast<int>(a.Code()));
+  BOOST_CHECK_EQUAL(1, executor.threads_.size());  // B once, not endless
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_single_instance_cycle_over_task) {
+  // arrange
+  ThreadExecutor executor;
+  std::unique_ptr<cf::Core> core = BuildParallelCycle(&executor, true);
+  BOOST_CHECK(core);
+
+  // act
+  UPtr<ParallelCycleA> a = core->Get<ParallelCycleA>();  // does not deadlock
+
+  // assert
+  BOOST_CHECK(!a.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kCyclicDependency),
+                    static_cast<int>(a.Code()));
+}
+
+BOOST_AUTO_TEST_CASE(test_executor_needs_list_of_dependencies) {
+  // arrange
+  ThreadExecutor executor;
+  cf::Builder builder;
+  builder
+      .Register<MockUnitLevel_2>(
+          [](cf::Resolver& resolver) -> MockUnitLevel_2* {
+            return Create<MockUnitLevel_2_B>();
+          })
+      .ResolveInParallel(&executor);
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(!core);
+  BOOST_CHECK(!builder.Error().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
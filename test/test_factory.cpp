@@ -0,0 +1,182 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+namespace {
+
+struct FactoryHolder {
+  explicit FactoryHolder(Factory<MockUnitLevel_2> create_level_2)
+      : create_level_2(create_level_2){};
+
+  Factory<MockUnitLevel_2> create_level_2;
+};
+
+std::unique_ptr<cf::Core> BuildFactory(const char* key) {
+  cf::Builder builder;
+  builder
+      .Register<MockUnitLevel_2>(
+          [](cf::Resolver& resolver) -> MockUnitLevel_2* {
+            return Create<MockUnitLevel_2_B>();
+          })
+      .SetKey("B");
+  builder.Register<FactoryHolder>(
+      [key](cf::Resolver& resolver) -> FactoryHolder* {
+        return new FactoryHolder(resolver.GetFactory<MockUnitLevel_2>(key));
+      });
+  return builder.BuildUnique();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestFactory)
+
+BOOST_AUTO_TEST_CASE(test_factory_create_many) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildFactory("B");
+  UPtr<FactoryHolder> holder = core->Get<FactoryHolder>();
+  BOOST_CHECK(holder.IsValid());
+  Factory<MockUnitLevel_2> copy = holder->create_level_2;
+
+  // act
+  UPtr<MockUnitLevel_2> level_2_1 = holder->create_level_2();
+  UPtr<MockUnitLevel_2> level_2_2 = holder->create_level_2();
+  UPtr<MockUnitLevel_2> level_2_3 = copy();
+
+  // assert
+  BOOST_CHECK(copy.IsValid());
+  BOOST_CHECK(level_2_1.IsValid());
+  BOOST_CHECK(level_2_2.IsValid());
+  BOOST_CHECK(level_2_3.IsValid());
+  BOOST_CHECK(level_2_1.Get() != level_2_2.Get());
+  BOOST_CHECK(level_2_2.Get() != level_2_3.Get());
+}
+
+BOOST_AUTO_TEST_CASE(test_factory_not_registered) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildFactory("C");
+
+  // act
+  UPtr<FactoryHolder> holder = core->Get<FactoryHolder>();
+
+  // assert
+  BOOST_CHECK(!holder.IsValid());
+  BOOST_CHECK(holder.Error().find("/C") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_factory_empty) {
+  // arrange
+  Factory<MockUnitLevel_3> create_level_3;
+
+  // act
+  UPtr<MockUnitLevel_3> level_3 = create_level_3();
+
+  // assert
+  BOOST_CHECK(!create_level_3.IsValid());
+  BOOST_CHECK(!level_3.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kEmptyHandle),
+                    static_cast<int>(level_3.Code()));
+}
+
+BOOST_AUTO_TEST_CASE(test_factory_in_creator_does_not_share) {
+  // arrange
+  MockUnitLevel_3* product_1 = nullptr;
+  MockUnitLevel_3* product_2 = nullptr;
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>().ShareInResolution();
+  builder.Register<MockUnitLevel_2>(
+      [&](cf::Resolver& resolver) -> MockUnitLevel_2* {
+        Factory<MockUnitLevel_3> create =
+            resolver.GetFactory<MockUnitLevel_3>();
+        UPtr<MockUnitLevel_3> level_3_1 = create();
+        UPtr<MockUnitLevel_3> level_3_2 = create();
+        product_1 = level_3_1.Get();
+        product_2 = level_3_2.Get();
+        return resolver.Construct<MockUnitLevel_2_A>(
+            resolver.Get<MockUnitLevel_3>());
+      });
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // act
+  UPtr<MockUnitLevel_2> level_2 = core->Get<MockUnitLevel_2>();
+
+  // assert
+  BOOST_CHECK(level_2.IsValid());
+  BOOST_CHECK(product_1 != nullptr);
+  BOOST_CHECK(product_2 != nullptr);
+  BOOST_CHECK(product_1 != product_2);
+}
+
+BOOST_AUTO_TEST_CASE(test_factory_in_creator_outlives_arena) {
+  // arrange
+  UPtr<MockUnitLevel_3> product{
+      PtrHolder<BaseContext<MockUnitLevel_3>>(nullptr)};
+  Arena* product_arena = reinterpret_cast<Arena*>(1);
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>();
+  builder
+      .Register<MockUnitLevel_3>(
+          [&](cf::Resolver& resolver) -> MockUnitLevel_3* {
+            product_arena = Arena::Current();
+            return resolver.Construct<MockUnitLevel_3>();
+          })
+      .SetKey("product");
+  builder
+      .Register<MockUnitLevel_2>(
+          [&](cf::Resolver& resolver) -> MockUnitLevel_2* {
+            // the product is kept outside of the tree
+            product = resolver.GetFactory<MockUnitLevel_3>("product")();
+            return resolver.Construct<MockUnitLevel_2_A>(
+                resolver.Get<MockUnitLevel_3>());
+          })
+      .UseArena();
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // act
+  UPtr<MockUnitLevel_2> level_2 = core->Get<MockUnitLevel_2>();
+  level_2.Reset();  // the arena of the tree is deleted
+  uintptr_t product_ptr = product->getMyPtr();  // use after free in arena
+  product.Reset();
+
+  // assert
+  BOOST_CHECK(product_arena == nullptr);
+  BOOST_CHECK(product_ptr != 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
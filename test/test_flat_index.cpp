@@ -0,0 +1,116 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+
+#include "common.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestFlatIndex)
+
+BOOST_AUTO_TEST_CASE(test_flat_index_normal_case) {
+  // arrange
+  FlatIndex<int*> index;
+  int value_1 = 1;
+  int value_2 = 2;
+
+  // act
+  bool result_1 = index.Insert(1, "A", 1, &value_1);
+  bool result_2 = index.Insert(2, "A", 1, &value_2);
+
+  // assert
+  BOOST_CHECK(result_1);
+  BOOST_CHECK(result_2);
+  BOOST_CHECK_EQUAL(2, index.Size());
+  BOOST_CHECK_EQUAL(&value_1, index.Find(1, "A", 1));
+  BOOST_CHECK_EQUAL(&value_2, index.Find(2, "A", 1));
+  BOOST_CHECK(index.Find(1, "B", 1) == nullptr);
+  BOOST_CHECK(index.Find(3, "A", 1) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_index_insert_key_twice) {
+  // arrange
+  FlatIndex<int*> index;
+  int value_1 = 1;
+  int value_2 = 2;
+  BOOST_CHECK(index.Insert(1, "A", 1, &value_1));
+
+  // act
+  bool result = index.Insert(1, "A", 1, &value_2);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK_EQUAL(1, index.Size());
+  BOOST_CHECK_EQUAL(&value_1, index.Find(1, "A", 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_index_grow_and_freeze) {
+  // arrange
+  const int count = 4096;
+  std::vector<int> values(count);
+  FlatIndex<int*> index;
+  for (int i = 0; i < count; ++i) {
+    std::string key = "key_" + std::to_string(i);
+    BOOST_CHECK(index.Insert(i % 7, key.data(), key.size(), &values[i]));
+  }
+
+  // act
+  index.Freeze();
+
+  // assert
+  BOOST_CHECK(index.IsFrozen());
+  BOOST_CHECK_EQUAL(count, index.Size());
+  BOOST_CHECK(index.slots_.size() * 7 >= index.Size() * 8);
+  BOOST_CHECK(!index.Insert(0, "new", 3, &values[0]));
+  for (int i = 0; i < count; ++i) {
+    std::string key = "key_" + std::to_string(i);
+    BOOST_CHECK_EQUAL(&values[i], index.Find(i % 7, key.data(), key.size()));
+    BOOST_CHECK(index.Find(i % 7 + 7, key.data(), key.size()) == nullptr);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_index_find_in_empty_index) {
+  // arrange
+  FlatIndex<int*> index;
+
+  // act
+  index.Freeze();
+
+  // assert
+  BOOST_CHECK(index.Find(0, "", 0) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -0,0 +1,103 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestHandle)
+
+BOOST_FIXTURE_TEST_CASE(test_handle_normal_case, Fixture) {
+  // arrange
+  Handle<MockUnitLevel_1> handle = core_->Resolve<MockUnitLevel_1>();
+
+  // act
+  UPtr<MockUnitLevel_1> uptr_1 = core_->Get(handle);
+  UPtr<MockUnitLevel_1> uptr_2 = core_->Get(handle);
+
+  // assert
+  BOOST_CHECK(handle.IsValid());
+  BOOST_CHECK(uptr_1.IsValid());
+  BOOST_CHECK(uptr_2.IsValid());
+  BOOST_CHECK(uptr_1.Get() != uptr_2.Get());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_1::getConstructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_handle_with_key, Fixture) {
+  // arrange
+  Handle<MockUnitLevel_2> handle = core_->Resolve<MockUnitLevel_2>("B");
+
+  // act
+  UPtr<MockUnitLevel_2> uptr = core_->Get(handle);
+
+  // assert
+  BOOST_CHECK(handle.IsValid());
+  BOOST_CHECK(uptr.IsValid());
+  BOOST_CHECK(dynamic_cast<MockUnitLevel_2_B*>(uptr.Get()) != nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_handle_type_is_not_registered, Fixture) {
+  // arrange
+  Handle<MockUnitNotRegistered> handle = core_->Resolve<MockUnitNotRegistered>();
+
+  // act
+  UPtr<MockUnitNotRegistered> uptr = core_->Get(handle);
+
+  // assert
+  BOOST_CHECK(!handle.IsValid());
+  BOOST_CHECK(!uptr.IsValid());
+  BOOST_CHECK(!uptr.Error().empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_handle_used_by_resolver, Fixture) {
+  // arrange
+  Handle<MockUnitLevel_3> handle = core_->Resolve<MockUnitLevel_3>();
+  Handle<MockUnitNotRegistered> empty_handle;
+  Context<MockUnitLevel_2> context;
+  cf::Resolver resolver(core_, &context);
+
+  // act
+  MockUnitLevel_3* item = resolver.Get(handle);
+  BOOST_CHECK(context.IsValid());
+  MockUnitNotRegistered* empty_item = resolver.Get(empty_handle);
+
+  // assert
+  BOOST_CHECK(item != nullptr);
+  BOOST_CHECK(empty_item == nullptr);
+  BOOST_CHECK(!context.IsValid());
+  BOOST_CHECK_EQUAL(2, context.DependencyCount());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
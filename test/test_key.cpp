@@ -0,0 +1,132 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+
+#include "common.h"
+
+namespace cpptoolkit {
+namespace factory {
+
+namespace {
+enum class MockKeyEnum { kFirst = 1, kSecond = 2 };
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestKey)
+
+BOOST_AUTO_TEST_CASE(test_key_from_string) {
+  // arrange
+  std::string value = "DB_AND_FILE";
+
+  // act
+  Key key_1(value);
+  Key key_2("DB_AND_FILE");
+
+  // assert
+  BOOST_CHECK_EQUAL(value.data(), key_1.Data());
+  BOOST_CHECK_EQUAL(key_1.Size(), key_2.Size());
+  BOOST_CHECK(std::memcmp(key_1.Data(), key_2.Data(), key_1.Size()) == 0);
+  BOOST_CHECK_EQUAL(value, key_2.ToString());
+  BOOST_CHECK(!key_1.IsDefault());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_from_null) {
+  // arrange
+  const char* value = nullptr;
+
+  // act
+  Key key_1(value);
+  Key key_2(value, 5);
+
+  // assert
+  BOOST_CHECK_EQUAL(0, key_1.Size());
+  BOOST_CHECK_EQUAL(0, key_2.Size());
+  BOOST_CHECK(key_1.Data() != nullptr);
+  BOOST_CHECK_EQUAL("", key_1.ToString());
+  BOOST_CHECK(!key_1.IsDefault());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_default) {
+  // arrange and act
+  Key key_1(engine::DEFAULT_KEY);
+  Key key_2("default");
+
+  // assert
+  BOOST_CHECK(key_1.IsDefault());
+  BOOST_CHECK(key_2.IsDefault());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_from_number) {
+  // arrange and act
+  Key key_1(42);
+  Key key_2(-7L);
+  Key key_3(MockKeyEnum::kSecond);
+  Key key_4(2u);
+  Key key_copy = key_1;
+
+  // assert
+  BOOST_CHECK_EQUAL("42", key_1.ToString());
+  BOOST_CHECK_EQUAL("-7", key_2.ToString());
+  BOOST_CHECK_EQUAL("2", key_3.ToString());
+  BOOST_CHECK_EQUAL(key_3.Size(), key_4.Size());
+  BOOST_CHECK(std::memcmp(key_3.Data(), key_4.Data(), key_3.Size()) == 0);
+  BOOST_CHECK(std::memcmp(key_1.Data(), key_copy.Data(), key_1.Size()) == 0);
+  BOOST_CHECK(key_copy.Data() != key_1.Data());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_number_is_not_equal_to_string) {
+  // arrange and act
+  Key key_1(1);
+  Key key_2("1");
+
+  // assert
+  BOOST_CHECK(key_1.Size() != key_2.Size());
+}
+
+BOOST_AUTO_TEST_CASE(test_key_string_of_number_form_is_reserved) {
+  // arrange
+  Key number(1);
+  std::string data(number.Data(), number.Size());
+
+  // act
+  Key key_1(number.Data(), number.Size());
+  Key key_2(data);
+  Key key_3("\0abc", 4);
+
+  // assert
+  BOOST_CHECK(!number.IsReserved());
+  BOOST_CHECK(key_1.IsReserved());
+  BOOST_CHECK(key_2.IsReserved());
+  BOOST_CHECK(!key_3.IsReserved());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -0,0 +1,274 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+namespace {
+
+struct LazyHolder {
+  explicit LazyHolder(Lazy<MockUnitLevel_3>&& level_3)
+      : level_3(std::move(level_3)){};
+
+  Lazy<MockUnitLevel_3> level_3;
+};
+
+struct MovedLazyHolder {
+  explicit MovedLazyHolder(Lazy<MockUnitLevel_3>&& level_3)
+      : source(std::move(level_3)), target(std::move(source)){};
+
+  Lazy<MockUnitLevel_3> source;  // moved-from
+  Lazy<MockUnitLevel_3> target;
+};
+
+struct LazyUser {
+  explicit LazyUser(LazyHolder* holder)
+      : level_3(holder != nullptr ? holder->level_3.Get() : nullptr){};
+
+  MockUnitLevel_3* level_3;  // the first use of the lazy dependency
+};
+
+std::unique_ptr<cf::Core> BuildLazy(bool register_level_3) {
+  cf::Builder builder;
+  if (register_level_3) {
+    builder.RegisterType<MockUnitLevel_3>();
+  }
+
+  builder.Register<LazyHolder>([](cf::Resolver& resolver) -> LazyHolder* {
+    return new LazyHolder(resolver.GetLazy<MockUnitLevel_3>());
+  });
+  return builder.BuildUnique();
+}
+
+size_t DependencyCount(UPtr<LazyHolder>& holder) {
+  return static_cast<Context<LazyHolder>*>(holder.context_.Get())
+      ->DependencyCount();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestLazy)
+
+BOOST_AUTO_TEST_CASE(test_lazy_not_used) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildLazy(true);
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+
+  // assert
+  BOOST_CHECK(holder.IsValid());
+  BOOST_CHECK_EQUAL(0, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(0, DependencyCount(holder));
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_created_on_first_use) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildLazy(true);
+  MockUnitLevel_3::reset();
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+
+  // act
+  MockUnitLevel_3* level_3 = holder->level_3.Get();
+  MockUnitLevel_3* level_3_2 = holder->level_3.Get();
+  size_t dependency_count = DependencyCount(holder);
+  holder.Reset();
+
+  // assert
+  BOOST_CHECK(level_3 != nullptr);
+  BOOST_CHECK(level_3 == level_3_2);
+  BOOST_CHECK_EQUAL(1, dependency_count);  // owned by the context of holder
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_first_use_in_threads) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildLazy(true);
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+  std::vector<MockUnitLevel_3*> instances(4, nullptr);
+  std::vector<std::thread> threads;
+
+  // act
+  for (size_t i = 0; i < instances.size(); ++i) {
+    threads.emplace_back([&holder, &instances, i]() {
+      instances[i] = holder->level_3.Get();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // assert
+  for (MockUnitLevel_3* instance : instances) {
+    BOOST_CHECK(instance != nullptr);
+    BOOST_CHECK(instance == instances[0]);
+  }
+  BOOST_CHECK_EQUAL(1, DependencyCount(holder));
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_first_use_of_lock_pool_in_threads) {
+  // arrange
+  cf::Builder builder;
+  builder
+      .Register<MockUnitLevel_3>([](cf::Resolver& resolver) -> MockUnitLevel_3* {
+        // other threads come while the dependency is created
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return new MockUnitLevel_3();
+      })
+      .AsLockPoolInstance(1);
+  builder.Register<LazyHolder>([](cf::Resolver& resolver) -> LazyHolder* {
+    return new LazyHolder(resolver.GetLazy<MockUnitLevel_3>());
+  });
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  MockUnitLevel_3::reset();
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+  std::vector<MockUnitLevel_3*> instances(4, nullptr);
+  std::vector<std::thread> threads;
+
+  // act
+  for (size_t i = 0; i < instances.size(); ++i) {
+    threads.emplace_back([&holder, &instances, i]() {
+      instances[i] = holder->level_3.Get();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // assert
+  for (MockUnitLevel_3* instance : instances) {
+    BOOST_CHECK(instance != nullptr);
+    BOOST_CHECK(instance == instances[0]);
+  }
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(1, DependencyCount(holder));
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_of_single_instance_used_in_arena_tree) {
+  // arrange
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>();
+  builder
+      .Register<LazyHolder>([](cf::Resolver& resolver) -> LazyHolder* {
+        return new LazyHolder(resolver.GetLazy<MockUnitLevel_3>());
+      })
+      .AsSingleInstance();
+  builder
+      .Register<LazyUser>([](cf::Resolver& resolver) -> LazyUser* {
+        return new LazyUser(resolver.Get<LazyHolder>());
+      })
+      .UseArena();
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<LazyUser> user = core->Get<LazyUser>();
+  MockUnitLevel_3* level_3 = user->level_3;
+  user.Reset();  // the arena of the tree is deleted
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+  MockUnitLevel_3* level_3_2 = holder->level_3.Get();
+  holder.Reset();
+  core.reset();  // the single instance releases its lazy dependency
+
+  // assert
+  BOOST_CHECK(level_3 != nullptr);
+  BOOST_CHECK(level_3 == level_3_2);
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_not_registered) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildLazy(false);
+
+  // act
+  UPtr<LazyHolder> holder = core->Get<LazyHolder>();
+
+  // assert
+  BOOST_CHECK(!holder.IsValid());
+  BOOST_CHECK_EQUAL(static_cast<int>(ErrorCode::kNotRegistered),
+                    static_cast<int>(holder.Code()));
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_moved_from_is_empty) {
+  // arrange
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>();
+  builder.Register<MovedLazyHolder>(
+      [](cf::Resolver& resolver) -> MovedLazyHolder* {
+        return new MovedLazyHolder(resolver.GetLazy<MockUnitLevel_3>());
+      });
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  MockUnitLevel_3::reset();
+  UPtr<MovedLazyHolder> holder = core->Get<MovedLazyHolder>();
+
+  // act
+  MockUnitLevel_3* moved_from = holder->source.Get();
+  MockUnitLevel_3* moved_to = holder->target.Get();
+  size_t dependency_count =
+      static_cast<Context<MovedLazyHolder>*>(holder.context_.Get())
+          ->DependencyCount();
+
+  // assert
+  BOOST_CHECK(moved_from == nullptr);
+  BOOST_CHECK(!holder->source.Error().empty());
+  BOOST_CHECK(moved_to != nullptr);
+  BOOST_CHECK_EQUAL(1, dependency_count);
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_empty) {
+  // arrange
+  Lazy<MockUnitLevel_3> lazy;
+
+  // act
+  MockUnitLevel_3* instance = lazy.Get();
+
+  // assert
+  BOOST_CHECK(instance == nullptr);
+  BOOST_CHECK(!lazy.IsValid());
+  BOOST_CHECK(!lazy.Error().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -112,6 +112,31 @@ BOOST_FIXTURE_TEST_CASE(test_lock_pool_error_on_create, Fixture) {
   BOOST_CHECK_EQUAL(pool_size, manager.countdown_);
 }
 
+BOOST_FIXTURE_TEST_CASE(test_lock_pool_reuse_slot_context, Fixture) {
+  // arrange
+  LOCK_POOL_INSTANCE_MANAGEG_MACRO
+
+  // act
+  BaseContext<MockUnitLevel_3>* context_1 = nullptr;
+  {
+    UPtr<MockUnitLevel_3> uptr(manager.Get());
+    context_1 = static_cast<BaseContext<MockUnitLevel_3>*>(uptr.context_.Get());
+
+    UPtr<MockUnitLevel_3> uptr_2(std::move(uptr));
+    BOOST_CHECK(uptr_2.IsValid());
+    BOOST_CHECK(uptr.context_.Get() == nullptr);
+    BOOST_CHECK_EQUAL(0, manager.queue_.size());
+  }
+  BOOST_CHECK_EQUAL(1, manager.queue_.size());
+
+  PtrHolder<BaseContext<MockUnitLevel_3>> context_2 = manager.Get();
+
+  // assert
+  BOOST_CHECK_EQUAL(context_1, context_2.Get());  // the slot of the pool
+  BOOST_CHECK_EQUAL(0, manager.queue_.size());
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+}
+
 #undef LOCK_POOL_INSTANCE_MANAGEG_MACRO
 
 BOOST_AUTO_TEST_SUITE_END()
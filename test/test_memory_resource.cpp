@@ -0,0 +1,288 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+#include "mock/counting_resource.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestMemoryResource)
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_allocator) {
+  // arrange
+  CountingResource resource;
+  std::vector<int, ResourceAllocator<int>> vector(&resource);
+
+  // act
+  vector.push_back(1);
+  size_t bytes = resource.bytes;
+  vector.clear();
+  vector.shrink_to_fit();
+
+  // assert
+  BOOST_CHECK_EQUAL(1, resource.allocations);
+  BOOST_CHECK_EQUAL(sizeof(int), bytes);
+  BOOST_CHECK_EQUAL(0, resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_core) {
+  // arrange
+  CountingResource resource;
+  Builder builder(&resource);
+  builder.RegisterType<MockUnitLevel_3>();
+  builder.RegisterType<MockUnitLevel_2_B>().SetKey("B").AsSoftPoolInstance(2);
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  size_t build_allocations = resource.allocations;
+  UPtr<MockUnitLevel_3> level_3 = core->Get<MockUnitLevel_3>();
+  UPtr<MockUnitLevel_2_B> level_2 = core->Get<MockUnitLevel_2_B>("B");
+  size_t get_allocations = resource.allocations;
+  level_3.Reset();
+  level_2.Reset();
+  core.reset();
+
+  // assert
+  BOOST_CHECK(build_allocations > 0);  // managers, slabs and indices
+  BOOST_CHECK(get_allocations > build_allocations);  // contexts
+  BOOST_CHECK_EQUAL(0, resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_registration) {
+  // arrange
+  CountingResource core_resource;
+  CountingResource resource;
+  Builder builder(&core_resource);
+  builder.RegisterType<MockUnitLevel_3>().SetMemoryResource(&resource);
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  size_t core_allocations = core_resource.allocations;
+  size_t build_allocations = resource.allocations;
+  UPtr<MockUnitLevel_3> level_3 = core->Get<MockUnitLevel_3>();
+  size_t get_allocations = resource.allocations;
+  level_3.Reset();
+  core.reset();
+
+  // assert
+  BOOST_CHECK_EQUAL(core_allocations, core_resource.allocations);
+  BOOST_CHECK(build_allocations > 0);              // slab of contexts
+  // context and slab for contexts with the instance
+  BOOST_CHECK_EQUAL(build_allocations + 2, get_allocations);
+  BOOST_CHECK_EQUAL(0, core_resource.bytes);
+  BOOST_CHECK_EQUAL(0, resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_pool_registration) {
+  // arrange
+  CountingResource core_resource;
+  CountingResource soft_resource;
+  CountingResource lock_resource;
+  Builder builder(&core_resource);
+  builder.RegisterType<MockUnitLevel_3>();
+  builder.RegisterType<MockUnitLevel_2_A, MockUnitLevel_3>()
+      .AsSoftPoolInstance(2)
+      .SetMemoryResource(&soft_resource);
+  builder.RegisterType<MockUnitLevel_2_B>()
+      .AsLockPoolInstance(2)
+      .SetMemoryResource(&lock_resource);
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  size_t soft_build_allocations = soft_resource.allocations;
+  size_t lock_build_allocations = lock_resource.allocations;
+  UPtr<MockUnitLevel_2_A> soft = core->Get<MockUnitLevel_2_A>();
+  UPtr<MockUnitLevel_2_B> lock = core->Get<MockUnitLevel_2_B>();
+  size_t soft_get_allocations = soft_resource.allocations;
+  size_t lock_get_allocations = lock_resource.allocations;
+  soft.Reset();
+  lock.Reset();
+  core.reset();
+
+  // assert
+  // slots of the pools are in the resources of the registrations
+  BOOST_CHECK(soft_get_allocations > soft_build_allocations);
+  BOOST_CHECK(lock_get_allocations > lock_build_allocations);
+  BOOST_CHECK_EQUAL(0, core_resource.bytes);
+  BOOST_CHECK_EQUAL(0, soft_resource.bytes);
+  BOOST_CHECK_EQUAL(0, lock_resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_error_outlives_core) {
+  // arrange
+  CountingResource core_resource;
+  CountingResource resource;
+  Builder builder(&core_resource);
+  builder
+      .Register<MockUnitLevel_3>([](cf::Resolver& resolver) -> MockUnitLevel_3* {
+        return nullptr;
+      })
+      .SetMemoryResource(&resource);
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  UPtr<MockUnitLevel_3> level_3 = core->Get<MockUnitLevel_3>();
+  UPtr<MockUnitLevel_2> level_2 = core->Get<MockUnitLevel_2>();
+  core.reset();
+  size_t bytes = resource.bytes;
+  size_t core_bytes = core_resource.bytes;
+  level_3.Reset();
+  level_2.Reset();
+
+  // assert
+  BOOST_CHECK(bytes > 0);       // shared error of the manager
+  BOOST_CHECK(core_bytes > 0);  // error of not registered object
+  BOOST_CHECK_EQUAL(0, resource.bytes);
+  BOOST_CHECK_EQUAL(0, core_resource.bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_exhausted) {
+  // arrange
+  CountingResource resource;
+  Builder builder;
+  builder.RegisterType<MockUnitLevel_3>()
+      .SetKey("single")
+      .AsSingleInstance()
+      .SetMemoryResource(&resource);
+  builder.RegisterType<MockUnitLevel_3>()
+      .SetKey("multiple")
+      .AsMultipleInstance()
+      .SetMemoryResource(&resource);
+  builder.RegisterType<MockUnitLevel_3>()
+      .SetKey("soft")
+      .AsSoftPoolInstance(2)
+      .SetMemoryResource(&resource);
+  builder.RegisterType<MockUnitLevel_3>()
+      .SetKey("lock")
+      .AsLockPoolInstance(2)
+      .SetMemoryResource(&resource);
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // act
+  resource.is_exhausted = true;
+  UPtr<MockUnitLevel_3> single = core->Get<MockUnitLevel_3>("single");
+  UPtr<MockUnitLevel_3> multiple = core->Get<MockUnitLevel_3>("multiple");
+  UPtr<MockUnitLevel_3> soft = core->Get<MockUnitLevel_3>("soft");
+  UPtr<MockUnitLevel_3> lock = core->Get<MockUnitLevel_3>("lock");
+
+  // assert
+  BOOST_CHECK(single.Code() == ErrorCode::kNoMemory);
+  BOOST_CHECK(multiple.Code() == ErrorCode::kNoMemory);
+  BOOST_CHECK(soft.Code() == ErrorCode::kNoMemory);
+  BOOST_CHECK(lock.Code() == ErrorCode::kNoMemory);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_index_exhausted) {
+  // arrange
+  CountingResource resource;
+  FlatIndex<int*> index(&resource);
+  int value_1 = 1;
+  int value_2 = 2;
+  BOOST_CHECK(index.Insert(1, "A", 1, &value_1));
+
+  const std::string key(32, 'B');  // the buffer of keys has to grow
+
+  // act
+  resource.is_exhausted = true;
+  bool result = index.Insert(1, key.data(), key.size(), &value_2);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK_EQUAL(1, index.Size());
+  BOOST_CHECK_EQUAL(&value_1, index.Find(1, "A", 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_add_exhausted) {
+  // arrange
+  CountingResource resource;
+  CoreExtension core(&resource);
+  PtrHolder<MultipleInstanceManager<MockUnitLevel_3>> manager =
+      MakePtrHolder<MultipleInstanceManager<MockUnitLevel_3>>(
+          "MockUnitLevel_3",
+          [](cf::Resolver& resolver) -> MockUnitLevel_3* {
+            return new MockUnitLevel_3();
+          },
+          &core);
+
+  // act
+  resource.is_exhausted = true;
+  bool result = core.Add(std::move(manager));
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(!core.LastError().empty());
+  BOOST_CHECK(core.Find(TypeId<MockUnitLevel_3>()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_build_item_exhausted) {
+  // arrange
+  CountingResource resource;
+  CoreExtension core(&resource);
+  BuildItem<MockUnitLevel_3> item(
+      [](cf::Resolver& resolver) -> MockUnitLevel_3* {
+        return new MockUnitLevel_3();
+      });
+
+  // act
+  resource.is_exhausted = true;
+  bool result = item.Build(&core);
+
+  // assert
+  BOOST_CHECK(!result);
+  BOOST_CHECK(!item.Error().empty());
+  BOOST_CHECK_EQUAL(0, core.managers_.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_resource_lock_pool_exhausted) {
+  // arrange
+  CountingResource resource;
+  resource.is_exhausted = true;
+  Builder builder;
+  builder.RegisterType<MockUnitLevel_3>()
+      .AsLockPoolInstance(2)
+      .SetMemoryResource(&resource);
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // act
+  UPtr<MockUnitLevel_3> level_3 = core->Get<MockUnitLevel_3>();
+
+  // assert
+  BOOST_CHECK(level_3.Code() == ErrorCode::kNoMemory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -70,6 +70,87 @@ BOOST_FIXTURE_TEST_CASE(test_multiple_instance_manager_check_delete_instance,
   BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
 }
 
+BOOST_FIXTURE_TEST_CASE(test_multiple_instance_manager_reuse_context_memory,
+                        Fixture) {
+  // arrange
+  MULTIPLE_INSTANCE_MANAGEG_MACRO;
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder = manager.Get();
+  BaseContext<MockUnitLevel_3>* context = ptr_holder.Get();
+  ptr_holder.Reset();
+
+  // act
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_2 = manager.Get();
+  BaseContext<MockUnitLevel_3>* context_2 = ptr_holder_2.Get();
+  ptr_holder_2.Reset();
+  size_t cache_size = manager.context_slab_->Size();
+  manager.TrimCache();
+
+  // assert
+  BOOST_CHECK_EQUAL(context, context_2);
+  BOOST_CHECK_EQUAL(1, cache_size);
+  BOOST_CHECK_EQUAL(0, manager.context_slab_->Size());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_multiple_instance_manager_construct_in_context,
+                        Fixture) {
+  // arrange
+  MultipleInstanceManager<MockUnitLevel_2> manager(
+      "MockUnitLevel_2",
+      [](cf::Resolver& resolver) -> MockUnitLevel_2* {
+        return resolver.Construct<MockUnitLevel_2_B>();
+      },
+      core_);
+
+  // act
+  PtrHolder<BaseContext<MockUnitLevel_2>> ptr_holder = manager.Get();
+  Context<MockUnitLevel_2>* context =
+      static_cast<Context<MockUnitLevel_2>*>(ptr_holder.Get());
+  bool first_in_storage = context->IsInStorage(context->GetInstance());
+  ptr_holder.Reset();
+
+  PtrHolder<BaseContext<MockUnitLevel_2>> ptr_holder_2 = manager.Get();
+  Context<MockUnitLevel_2>* context_2 =
+      static_cast<Context<MockUnitLevel_2>*>(ptr_holder_2.Get());
+  bool second_in_storage = context_2->IsInStorage(context_2->GetInstance());
+  ptr_holder_2.Reset();
+
+  // assert
+  BOOST_CHECK(!first_in_storage);  // the size is not known yet
+  BOOST_CHECK(second_in_storage);
+  BOOST_CHECK(manager.instance_slab_.load() != nullptr);
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_2::getConstructorCounter());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_2::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_multiple_instance_manager_learn_dependency_count,
+                        Fixture) {
+  // arrange
+  MultipleInstanceManager<MockUnitLevel_3> manager(
+      "MockUnitLevel_3",
+      [](cf::Resolver& resolver) -> MockUnitLevel_3* {
+        for (int i = 0; i < 6; ++i) {
+          resolver.Get<MockUnitLevel_3>();
+        }
+        return new MockUnitLevel_3();
+      },
+      core_);
+
+  // act
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder = manager.Get();
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_2 = manager.Get();
+  Context<MockUnitLevel_3>* context =
+      static_cast<Context<MockUnitLevel_3>*>(ptr_holder_2.Get());
+
+  // assert
+  BOOST_CHECK(ptr_holder->IsValid());
+  BOOST_CHECK(ptr_holder_2->IsValid());
+  BOOST_CHECK_EQUAL(6, manager.dependency_count_.load());
+  BOOST_CHECK(manager.instance_slab_.load() != nullptr);
+  BOOST_CHECK_EQUAL(6, static_cast<size_t>(context->dependency_capacity_));
+  BOOST_CHECK_EQUAL(0, static_cast<int>(context->owns_dependencies_));
+}
+
 #undef MULTIPLE_INSTANCE_MANAGEG_MACRO
 
 BOOST_AUTO_TEST_SUITE_END()
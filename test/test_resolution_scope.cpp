@@ -0,0 +1,235 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/builder.h>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+namespace {
+
+// MockUnitLevel_1 depends on two MockUnitLevel_2_A, each of them depends on
+// MockUnitLevel_3
+std::unique_ptr<cf::Core> BuildDiamond(bool share, bool use_arena) {
+  cf::Builder builder;
+  BuildItem<MockUnitLevel_3, TypeCreator<MockUnitLevel_3>>& level_3 =
+      builder.RegisterType<MockUnitLevel_3>();
+  if (share) {
+    level_3.ShareInResolution();
+  }
+
+  builder
+      .Register<MockUnitLevel_2>(
+          [](cf::Resolver& resolver) -> MockUnitLevel_2* {
+            return Create<MockUnitLevel_2_A>(resolver.Get<MockUnitLevel_3>());
+          })
+      .SetKey("A");
+  builder
+      .Register<MockUnitLevel_2>(
+          [](cf::Resolver& resolver) -> MockUnitLevel_2* {
+            return Create<MockUnitLevel_2_A>(resolver.Get<MockUnitLevel_3>());
+          })
+      .SetKey("C");
+  auto& level_1 = builder.Register<MockUnitLevel_1>(
+      [](cf::Resolver& resolver) -> MockUnitLevel_1* {
+        return Create<MockUnitLevel_1>(resolver.Get<MockUnitLevel_2>("A"),
+                                       resolver.Get<MockUnitLevel_2>("C"));
+      });
+  if (use_arena) {
+    level_1.UseArena();
+  }
+
+  return builder.BuildUnique();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TestResolutionScope)
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_find) {
+  // arrange
+  int owner = 0;
+  ScopeEntry entry{&owner, nullptr, nullptr, nullptr};
+  ResolutionScope* outer = nullptr;
+  ResolutionScope* inner = nullptr;
+  AContext* found = nullptr;
+  AContext* other_arena = nullptr;
+
+  // act
+  {
+    ResolutionScope scope(true);
+    outer = ResolutionScope::Current();
+    ResolutionScope nested(true);  // the tree already has a scope
+    inner = ResolutionScope::Current();
+    scope.Add(&entry);
+    entry.context = reinterpret_cast<AContext*>(&entry);
+    found = scope.Find(&owner, nullptr);
+    other_arena = scope.Find(&owner, reinterpret_cast<Arena*>(&owner));
+    entry.context = nullptr;
+    scope.entries_ = nullptr;  // nothing to release
+  }
+
+  // assert
+  BOOST_CHECK(outer != nullptr);
+  BOOST_CHECK(inner == outer);
+  BOOST_CHECK(found == reinterpret_cast<AContext*>(&entry));
+  BOOST_CHECK(other_arena == nullptr);
+  BOOST_CHECK(ResolutionScope::Current() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_closed) {
+  // arrange
+  ResolutionScope scope(false);
+
+  // act
+  ResolutionScope* current = ResolutionScope::Current();
+
+  // assert
+  BOOST_CHECK(current == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_not_shared_by_default) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildDiamond(false, false);
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<MockUnitLevel_1> level_1 = core->Get<MockUnitLevel_1>();
+
+  // assert
+  BOOST_CHECK(level_1.IsValid());
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getConstructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_shared_leaf) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildDiamond(true, false);
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<MockUnitLevel_1> level_1 = core->Get<MockUnitLevel_1>();
+  int32_t created = MockUnitLevel_3::getConstructorCounter();
+  UPtr<MockUnitLevel_1> level_1_2 = core->Get<MockUnitLevel_1>();
+  int32_t created_2 = MockUnitLevel_3::getConstructorCounter();
+  level_1.Reset();
+  int32_t deleted = MockUnitLevel_3::getDestructorCounter();
+  level_1_2.Reset();
+
+  // assert
+  BOOST_CHECK_EQUAL(1, created);    // once in the tree
+  BOOST_CHECK_EQUAL(2, created_2);  // once per resolution
+  BOOST_CHECK_EQUAL(1, deleted);
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getDestructorCounter());
+  BOOST_CHECK(ResolutionScope::Current() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_shared_leaf_in_arena) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildDiamond(true, true);
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<MockUnitLevel_1> level_1 = core->Get<MockUnitLevel_1>();
+  int32_t created = MockUnitLevel_3::getConstructorCounter();
+  level_1.Reset();
+
+  // assert
+  BOOST_CHECK_EQUAL(1, created);
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_top_level_leaf) {
+  // arrange
+  std::unique_ptr<cf::Core> core = BuildDiamond(true, false);
+
+  // act
+  UPtr<MockUnitLevel_3> level_3_1 = core->Get<MockUnitLevel_3>();
+  UPtr<MockUnitLevel_3> level_3_2 = core->Get<MockUnitLevel_3>();
+
+  // assert
+  BOOST_CHECK(level_3_1.IsValid());
+  BOOST_CHECK(level_3_1.Get() != level_3_2.Get());
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_top_level_get_in_creator) {
+  // arrange
+  cf::Core* core_ptr = nullptr;
+  bool is_shared_by_get = true;
+  bool is_shared_by_handle = true;
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>().ShareInResolution();
+  builder.Register<MockUnitLevel_2>(
+      [&core_ptr, &is_shared_by_get,
+       &is_shared_by_handle](cf::Resolver& resolver) -> MockUnitLevel_2* {
+        MockUnitLevel_3* level_3 = resolver.Get<MockUnitLevel_3>();
+        // the roots of new resolutions
+        UPtr<MockUnitLevel_3> by_get = core_ptr->Get<MockUnitLevel_3>();
+        UPtr<MockUnitLevel_3> by_handle =
+            core_ptr->Get(core_ptr->Resolve<MockUnitLevel_3>());
+        is_shared_by_get = by_get.Get() == level_3;
+        is_shared_by_handle = by_handle.Get() == level_3;
+        return Create<MockUnitLevel_2_A>(level_3);
+      });
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+  core_ptr = core.get();
+  MockUnitLevel_3::reset();
+
+  // act
+  UPtr<MockUnitLevel_2> level_2 = core->Get<MockUnitLevel_2>();
+
+  // assert
+  BOOST_CHECK(level_2.IsValid());
+  BOOST_CHECK(!is_shared_by_get);
+  BOOST_CHECK(!is_shared_by_handle);
+  BOOST_CHECK_EQUAL(3, MockUnitLevel_3::getConstructorCounter());
+}
+
+BOOST_AUTO_TEST_CASE(test_resolution_scope_only_multiple_instance) {
+  // arrange
+  cf::Builder builder;
+  builder.RegisterType<MockUnitLevel_3>()
+      .AsSingleInstance()
+      .ShareInResolution();
+
+  // act
+  std::unique_ptr<cf::Core> core = builder.BuildUnique();
+
+  // assert
+  BOOST_CHECK(!core);
+  BOOST_CHECK(!builder.Error().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
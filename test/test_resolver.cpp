@@ -45,7 +45,7 @@ BOOST_FIXTURE_TEST_CASE(test_resolver_normal_case, Fixture) {
 
   // assert
   BOOST_CHECK(item != nullptr);
-  BOOST_CHECK_EQUAL(1, base_context.dependencies_.size());
+  BOOST_CHECK_EQUAL(1, base_context.DependencyCount());
 }
 
 BOOST_FIXTURE_TEST_CASE(resolver_factory_returns_error, Fixture) {
@@ -60,7 +60,7 @@ BOOST_FIXTURE_TEST_CASE(resolver_factory_returns_error, Fixture) {
   // assert
   BOOST_CHECK(!context.Error().empty());
   BOOST_CHECK(!context.IsValid());
-  BOOST_CHECK_EQUAL(1, context.dependencies_.size());
+  BOOST_CHECK_EQUAL(1, context.DependencyCount());
   BOOST_CHECK_EQUAL(nullptr, instance);
 }
 
@@ -76,6 +76,42 @@ BOOST_FIXTURE_TEST_CASE(
   BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
 }
 
+BOOST_FIXTURE_TEST_CASE(test_single_instance_manager_shared_context,
+                        Fixture) {
+  // arrange
+  SINGLE_INSTANCE_MANAGEG_MACRO;
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder = manager.Get();
+
+  // act
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_2 = manager.Get();
+  ptr_holder_2.Reset();
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_3 = manager.Get();
+
+  // assert
+  BOOST_CHECK(ptr_holder.Get() == manager.weak_context_);
+  BOOST_CHECK(ptr_holder_3.Get() == manager.weak_context_);
+  BOOST_CHECK(ptr_holder_3->IsValid());
+  BOOST_CHECK(ptr_holder_3->GetInstance() != nullptr);
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(0, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_single_instance_manager_context_outlives_manager,
+                        Fixture) {
+  // arrange
+  PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder(nullptr);
+  {
+    SINGLE_INSTANCE_MANAGEG_MACRO;
+    ptr_holder = manager.Get();
+  }
+
+  // act
+  ptr_holder.Reset();  // the context is released after the manager
+
+  // assert
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
+}
+
 #undef SINGLE_INSTANCE_MANAGEG_MACRO
 
 BOOST_AUTO_TEST_SUITE_END()
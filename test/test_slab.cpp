@@ -0,0 +1,109 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+BOOST_AUTO_TEST_SUITE(TestSlab)
+
+BOOST_AUTO_TEST_CASE(test_slab_reuse_block) {
+  // arrange
+  Slab* slab = Slab::Create(32);
+
+  // act
+  void* block_1 = slab->Allocate();
+  slab->Free(block_1);
+  void* block_2 = slab->Allocate();
+
+  // assert
+  BOOST_CHECK(block_1 != nullptr);
+  BOOST_CHECK_EQUAL(block_1, block_2);
+  BOOST_CHECK_EQUAL(0, slab->Size());
+
+  slab->Free(block_2);
+  Slab::Detach(slab);
+}
+
+BOOST_AUTO_TEST_CASE(test_slab_capacity_and_trim) {
+  // arrange
+  Slab* slab = Slab::Create(32);
+  slab->SetCapacity(4);  // one block for every shard
+  void* block_1 = slab->Allocate();
+  void* block_2 = slab->Allocate();
+
+  // act
+  slab->Free(block_1);
+  slab->Free(block_2);  // the same shard (thread), the shard is full
+  size_t size = slab->Size();
+  slab->Trim();
+
+  // assert
+  BOOST_CHECK_EQUAL(1, size);
+  BOOST_CHECK_EQUAL(0, slab->Size());
+
+  Slab::Detach(slab);
+}
+
+BOOST_AUTO_TEST_CASE(test_slab_zero_capacity) {
+  // arrange
+  Slab* slab = Slab::Create(32);
+  slab->SetCapacity(0);
+
+  // act
+  slab->Free(slab->Allocate());
+
+  // assert
+  BOOST_CHECK_EQUAL(0, slab->Size());
+
+  Slab::Detach(slab);
+}
+
+BOOST_AUTO_TEST_CASE(test_slab_context_outlives_owner) {
+  // arrange
+  Slab* slab = Slab::Create(sizeof(SlabContext<Context<MockUnitLevel_3>>));
+  PtrHolder<Context<MockUnitLevel_3>> context =
+      MakeSlabContext<Context<MockUnitLevel_3>>(slab);
+
+  // act
+  Slab::Detach(slab);  // the slab is alive until the context is released
+  context->SetInstance(new MockUnitLevel_3());
+  context.Reset();
+
+  // assert
+  BOOST_CHECK(context.Get() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit
@@ -50,13 +50,31 @@ BOOST_FIXTURE_TEST_CASE(test_pool_normal_case, Fixture) {
   // act
   {
     PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_1 = manager.Get();
-    BOOST_CHECK_EQUAL(1, manager.index_.size());
+    BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
     PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_2 = manager.Get();
-    BOOST_CHECK_EQUAL(2, manager.index_.size());
+    BOOST_CHECK_EQUAL(2, MockUnitLevel_3::getConstructorCounter());
   }
 
   // assert
   BOOST_CHECK_EQUAL(2, manager.queue_.size());
+  BOOST_CHECK_EQUAL(0, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_pool_delete_object_if_pool_is_full, Fixture) {
+  // arrange
+  POOL_INSTANCE_MANAGEG_MACRO
+
+  // act
+  {
+    PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_1 = manager.Get();
+    PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_2 = manager.Get();
+    PtrHolder<BaseContext<MockUnitLevel_3>> ptr_holder_3 = manager.Get();
+  }
+
+  // assert
+  BOOST_CHECK_EQUAL(2, manager.queue_.size());
+  BOOST_CHECK_EQUAL(3, MockUnitLevel_3::getConstructorCounter());
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getDestructorCounter());
 }
 
 BOOST_FIXTURE_TEST_CASE(test_pool_queue_work, Fixture) {
@@ -100,7 +118,6 @@ BOOST_FIXTURE_TEST_CASE(test_pool_error_on_create, Fixture) {
 
   // assert
   BOOST_CHECK(!item->IsValid());
-  BOOST_CHECK_EQUAL(0, manager.index_.size());
   BOOST_CHECK_EQUAL(0, manager.queue_.size());
 }
 
@@ -0,0 +1,153 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2021, Vladimir Fomchenkov
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "common.h"
+
+#include <cpptoolkit/factory/static_core.h>
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace cpptoolkit {
+namespace factory {
+namespace engine {
+
+struct MockUnitThrowInConstructor {
+  MockUnitThrowInConstructor(MockUnitLevel_3*) {
+    throw std::runtime_error("MockUnitThrowInConstructor");
+  }
+};
+
+struct MockUnitThrowInConstructorTop {
+  MockUnitThrowInConstructorTop(MockUnitThrowInConstructor*) {}
+};
+
+typedef StaticCore<
+    Bind<MockUnitLevel_3, MockUnitLevel_3>,
+    Bind<MockUnitLevel_2, MockUnitLevel_2_A, MockUnitLevel_3>,
+    Bind<MockUnitLevel_1, MockUnitLevel_1, MockUnitLevel_2, MockUnitLevel_2>,
+    Single<MockUnitSingleInstance, MockUnitLevel_3>,
+    LockPool<MockUnitSingleInstanceTop, 2, MockUnitLevel_1,
+             MockUnitSingleInstance>,
+    Bind<MockUnitThrowInConstructor, MockUnitThrowInConstructor,
+         MockUnitLevel_3>,
+    Bind<MockUnitThrowInConstructorTop, MockUnitThrowInConstructorTop,
+         MockUnitThrowInConstructor>>
+    MockStaticCore;
+
+// the slots keep the creator without type erasure
+static_assert(
+    std::is_same<MockStaticCore::BindingOf<MockUnitLevel_2>::Manager,
+                 MultipleInstanceManager<
+                     MockUnitLevel_2,
+                     StaticCreator<MockStaticCore,
+                                   Bind<MockUnitLevel_2, MockUnitLevel_2_A,
+                                        MockUnitLevel_3>>>>::value,
+    "StaticCore manager keeps std::function");
+
+BOOST_AUTO_TEST_SUITE(TestStaticCore)
+
+BOOST_FIXTURE_TEST_CASE(test_static_core_multiple_instance, Fixture) {
+  // arrange
+  MockStaticCore core;
+
+  {
+    // act
+    UPtr<MockUnitLevel_1> uptr_1 = core.Get<MockUnitLevel_1>();
+    UPtr<MockUnitLevel_1> uptr_2 = core.Get<MockUnitLevel_1>();
+
+    // assert
+    BOOST_CHECK(uptr_1.IsValid());
+    BOOST_CHECK(uptr_2.IsValid());
+    BOOST_CHECK(uptr_1.Get() != uptr_2.Get());
+    BOOST_CHECK_EQUAL(2, MockUnitLevel_1::getConstructorCounter());
+    BOOST_CHECK_EQUAL(4, MockUnitLevel_2::getConstructorCounter());
+    BOOST_CHECK_EQUAL(4, MockUnitLevel_3::getConstructorCounter());
+  }
+
+  BOOST_CHECK_EQUAL(2, MockUnitLevel_1::getDestructorCounter());
+  BOOST_CHECK_EQUAL(4, MockUnitLevel_2::getDestructorCounter());
+  BOOST_CHECK_EQUAL(4, MockUnitLevel_3::getDestructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_static_core_single_instance, Fixture) {
+  // arrange
+  MockStaticCore core;
+
+  // act
+  UPtr<MockUnitSingleInstance> uptr_1 = core.Get<MockUnitSingleInstance>();
+  UPtr<MockUnitSingleInstance> uptr_2 = core.Get<MockUnitSingleInstance>();
+
+  // assert
+  BOOST_CHECK(uptr_1.IsValid());
+  BOOST_CHECK(uptr_1.Get() == uptr_2.Get());
+  BOOST_CHECK_EQUAL(1, MockUnitSingleInstance::getConstructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_static_core_pool_instance, Fixture) {
+  // arrange
+  MockStaticCore core;
+  MockUnitSingleInstanceTop* instance = nullptr;
+
+  {
+    UPtr<MockUnitSingleInstanceTop> uptr =
+        core.Get<MockUnitSingleInstanceTop>();
+    BOOST_CHECK(uptr.IsValid());
+    instance = uptr.Get();
+  }
+
+  // act
+  UPtr<MockUnitSingleInstanceTop> uptr = core.Get<MockUnitSingleInstanceTop>();
+
+  // assert
+  BOOST_CHECK(uptr.IsValid());
+  BOOST_CHECK(uptr.Get() == instance);
+  BOOST_CHECK_EQUAL(1, MockUnitSingleInstanceTop::getConstructorCounter());
+}
+
+BOOST_FIXTURE_TEST_CASE(test_static_core_error_in_dependency, Fixture) {
+  // arrange
+  MockStaticCore core;
+
+  // act
+  UPtr<MockUnitThrowInConstructorTop> uptr =
+      core.Get<MockUnitThrowInConstructorTop>();
+
+  // assert
+  BOOST_CHECK(!uptr.IsValid());
+  BOOST_CHECK(uptr.Error().find("MockUnitThrowInConstructor") !=
+              std::string::npos);
+  BOOST_CHECK_EQUAL(1, MockUnitLevel_3::getConstructorCounter());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace engine
+}  // namespace factory
+}  // namespace cpptoolkit